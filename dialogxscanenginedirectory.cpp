@@ -21,6 +21,8 @@
 #include "dialogxscanenginedirectory.h"
 #include "ui_dialogxscanenginedirectory.h"
 
+#include <QThread>
+
 DialogXScanEngineDirectory::DialogXScanEngineDirectory(QWidget *pParent) : XShortcutsDialog(pParent, true), ui(new Ui::DialogXScanEngineDirectory)
 {
     ui->setupUi(this);
@@ -28,6 +30,8 @@ DialogXScanEngineDirectory::DialogXScanEngineDirectory(QWidget *pParent) : XShor
     connect(this, SIGNAL(resultSignal(QString)), this, SLOT(appendResult(QString)));
 
     ui->checkBoxScanSubdirectories->setChecked(true);
+    // Engines that cannot be cloned scan serially whatever the value
+    ui->spinBoxThreads->setValue(QThread::idealThreadCount());
 
     m_pScanEngine = nullptr;
     m_scanOptions = {};
@@ -94,6 +98,7 @@ void DialogXScanEngineDirectory::scanDirectory(const QString &sDirectoryName)
         m_scanOptions.bShowVersion = true;
         m_scanOptions.bShowInfo = true;
         m_scanOptions.bSubdirectories = ui->checkBoxScanSubdirectories->isChecked();
+        m_scanOptions.nNumberOfThreads = ui->spinBoxThreads->value();
 
         quint64 nFlags = ui->comboBoxFlags->getValue().toULongLong();
         XScanEngine::setScanFlags(&m_scanOptions, nFlags);
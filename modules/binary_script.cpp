@@ -25,20 +25,32 @@ Binary_Script::Binary_Script(XBinary *pBinary, XBinary::FILEPART filePart, const
     this->m_pBinary = pBinary;
     this->m_filePart = filePart;
     this->m_pPdStruct = pPdStruct;
+    this->m_pPdStructSignature = pPdStruct;
+    this->m_pdStructSignature = XBinary::createPdStruct();
+    this->m_nSignatureWatch = -1;
     this->m_scanOptions = scanOptions;
 
     connect(pBinary, SIGNAL(errorMessage(QString)), this, SIGNAL(errorMessage(QString)));
     connect(pBinary, SIGNAL(infoMessage(QString)), this, SIGNAL(infoMessage(QString)));
 
+    XScanParseCache::RECORD parseRecord = {};
+
+    if (scanOptions.pParseCache) {
+        parseRecord = scanOptions.pParseCache->getRecord(pBinary, pPdStruct);
+    } else {
+        XScanParseCache::loadMemoryMap(pBinary, &parseRecord, pPdStruct);
+        XScanParseCache::loadFileFormatInfo(pBinary, &parseRecord, pPdStruct);
+    }
+
     m_nSize = pBinary->getSize();
-    m_memoryMap = pBinary->getMemoryMap(XBinary::MAPMODE_UNKNOWN, pPdStruct);
+    m_memoryMap = parseRecord.memoryMap;
     m_nBaseAddress = pBinary->getBaseAddress();
 
-    m_nEntryPointOffset = pBinary->getEntryPointOffset(&m_memoryMap);
-    m_nEntryPointAddress = pBinary->getEntryPointAddress(&m_memoryMap);
-    m_nOverlayOffset = pBinary->getOverlayOffset(&m_memoryMap, pPdStruct);
-    m_nOverlaySize = pBinary->getOverlaySize(&m_memoryMap, pPdStruct);
-    m_bIsOverlayPresent = pBinary->isOverlayPresent(&m_memoryMap, pPdStruct);
+    m_nEntryPointOffset = parseRecord.nEntryPointOffset;
+    m_nEntryPointAddress = parseRecord.nEntryPointAddress;
+    m_nOverlayOffset = parseRecord.nOverlayOffset;
+    m_nOverlaySize = parseRecord.nOverlaySize;
+    m_bIsOverlayPresent = parseRecord.bIsOverlayPresent;
     m_bIsBigEndian = pBinary->isBigEndian();
 
     m_sHeaderSignature = pBinary->getSignature(0, 256);  // TODO const
@@ -71,7 +83,7 @@ Binary_Script::Binary_Script(XBinary *pBinary, XBinary::FILEPART filePart, const
     }
 
     m_bIsSigned = pBinary->isSigned();
-    m_fileFormatInfo = pBinary->getFileFormatInfo(pPdStruct);
+    m_fileFormatInfo = parseRecord.fileFormatInfo;
     m_sOperationSystemInfoString = XBinary::getOperationSystemInfoString(&m_fileFormatInfo);
     m_sFileFormatInfoString = XBinary::getFileFormatInfoString(&m_fileFormatInfo);
 
@@ -81,10 +93,41 @@ Binary_Script::Binary_Script(XBinary *pBinary, XBinary::FILEPART filePart, const
     m_disasmOptions = {};
     m_disasmOptions.bIsUppercase = true;
     m_disasmCore.setMode(XBinary::getDisasmMode(&m_memoryMap));
+
+    if (m_scanOptions.bIsProfiling || m_scanOptions.pProfiler) {
+        m_profilingTimer.start();
+    }
 }
 
 Binary_Script::~Binary_Script()
 {
+    // The watchdog must not touch m_pdStructSignature after it is gone
+    finishSignature();
+}
+
+QByteArray Binary_Script::getHeaderBytes()
+{
+    return QByteArray::fromHex(m_sHeaderSignature.toLatin1());
+}
+
+QByteArray Binary_Script::getEntryPointBytes()
+{
+    return QByteArray::fromHex(m_sEntryPointSignature.toLatin1());
+}
+
+QByteArray Binary_Script::getOverlayBytes()
+{
+    return QByteArray::fromHex(m_sOverlaySignature.toLatin1());
+}
+
+void Binary_Script::setLiteralCandidates(const QBitArray &baCandidates)
+{
+    m_baLiteralCandidates = baCandidates;
+}
+
+QBitArray Binary_Script::getLiteralCandidates()
+{
+    return m_baLiteralCandidates;
 }
 
 qint64 Binary_Script::getSize()
@@ -104,7 +147,7 @@ bool Binary_Script::compare(const QString &sSignature, qint64 nOffset)
         (!_sSignature.contains('%')) && (!_sSignature.contains('*'))) {
         bResult = m_pBinary->compareSignatureStrings(m_sHeaderSignature.mid((int)((quint64)nOffset * 2), (int)((quint64)nSignatureSize * 2)), _sSignature);
     } else {
-        bResult = m_pBinary->compareSignature(&m_memoryMap, _sSignature, nOffset, m_pPdStruct);
+        bResult = m_pBinary->compareSignature(&m_memoryMap, _sSignature, nOffset, m_pPdStructSignature);
     }
 
     return bResult;
@@ -177,7 +220,7 @@ qint64 Binary_Script::findSignature(qint64 nOffset, qint64 nSize, const QString
 {
     qint64 nResult = -1;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     qint64 nResultSize = 0;
 
@@ -188,13 +231,13 @@ qint64 Binary_Script::findSignature(qint64 nOffset, qint64 nSize, const QString
     // QElapsedTimer timer;
     // timer.start();
 
-    nResult = m_pBinary->find_signature(&m_memoryMap, nOffset, nSize, sSignature, &nResultSize, m_pPdStruct);
+    nResult = m_pBinary->find_signature(&m_memoryMap, nOffset, nSize, sSignature, &nResultSize, m_pPdStructSignature);
 
     // qint64 nElapsed = timer.elapsed();
     // qDebug() << "findSignature END - Signature:" << sSignature << "Result:" << XBinary::valueToHexEx(nResult) << "Time:" << nElapsed << "ms";
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("find_signature[%1]: %2 %3").arg(sSignature, XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "find_signature", sSignature, nOffset, nSize);
     }
 
     return nResult;
@@ -204,14 +247,14 @@ qint64 Binary_Script::findString(qint64 nOffset, qint64 nSize, const QString &sS
 {
     qint64 nResult = -1;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     _fixOffsetAndSize(&nOffset, &nSize);
 
-    nResult = m_pBinary->find_ansiString(nOffset, nSize, sString, m_pPdStruct);
+    nResult = m_pBinary->find_ansiString(nOffset, nSize, sString, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("findString[%1]: %2 %3").arg(sString, XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "findString", sString, nOffset, nSize);
     }
 
     return nResult;
@@ -221,14 +264,14 @@ qint64 Binary_Script::findByte(qint64 nOffset, qint64 nSize, quint8 nValue)
 {
     qint64 nResult = -1;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     _fixOffsetAndSize(&nOffset, &nSize);
 
-    nResult = m_pBinary->find_uint8(nOffset, nSize, nValue, m_pPdStruct);
+    nResult = m_pBinary->find_uint8(nOffset, nSize, nValue, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("findByte[%1]: %2 %3").arg(XBinary::valueToHex(nValue), XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "findByte", XBinary::valueToHex(nValue), nOffset, nSize);
     }
 
     return nResult;
@@ -238,14 +281,14 @@ qint64 Binary_Script::findWord(qint64 nOffset, qint64 nSize, quint16 nValue)
 {
     qint64 nResult = -1;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     _fixOffsetAndSize(&nOffset, &nSize);
 
-    nResult = m_pBinary->find_uint16(nOffset, nSize, nValue, m_pPdStruct);
+    nResult = m_pBinary->find_uint16(nOffset, nSize, nValue, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("findWord[%1]: %2 %3").arg(XBinary::valueToHex(nValue), XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "findWord", XBinary::valueToHex(nValue), nOffset, nSize);
     }
 
     return nResult;
@@ -255,14 +298,14 @@ qint64 Binary_Script::findDword(qint64 nOffset, qint64 nSize, quint32 nValue)
 {
     qint64 nResult = -1;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     _fixOffsetAndSize(&nOffset, &nSize);
 
-    nResult = m_pBinary->find_uint32(nOffset, nSize, nValue, m_pPdStruct);
+    nResult = m_pBinary->find_uint32(nOffset, nSize, nValue, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("findDword[%1]: %2 %3").arg(XBinary::valueToHex(nValue), XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "findDword", XBinary::valueToHex(nValue), nOffset, nSize);
     }
 
     return nResult;
@@ -305,7 +348,7 @@ bool Binary_Script::compareOverlay(const QString &sSignature, qint64 nOffset)
         (!_sSignature.contains('%')) && (!_sSignature.contains('*'))) {
         bResult = m_pBinary->compareSignatureStrings(m_sOverlaySignature.mid(nOffset * 2, nSignatureSize * 2), _sSignature);
     } else {
-        bResult = m_pBinary->compareOverlay(&m_memoryMap, _sSignature, nOffset, m_pPdStruct);
+        bResult = m_pBinary->compareOverlay(&m_memoryMap, _sSignature, nOffset, m_pPdStructSignature);
     }
 
     return bResult;
@@ -315,12 +358,12 @@ bool Binary_Script::isSignaturePresent(qint64 nOffset, qint64 nSize, const QStri
 {
     bool bResult = false;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
-    bResult = m_pBinary->isSignaturePresent(&m_memoryMap, nOffset, nSize, sSignature, m_pPdStruct);
+    bResult = m_pBinary->isSignaturePresent(&m_memoryMap, nOffset, nSize, sSignature, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("isSignaturePresent[%1]: %2 %3").arg(sSignature, XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "isSignaturePresent", sSignature, nOffset, nSize);
     }
 
     return bResult;
@@ -389,7 +432,7 @@ QString Binary_Script::getSignature(qint64 nOffset, qint64 nSize)
 
 double Binary_Script::calculateEntropy(qint64 nOffset, qint64 nSize)
 {
-    return m_pBinary->getBinaryStatus(XBinary::BSTATUS_ENTROPY, nOffset, nSize, m_pPdStruct);
+    return m_pBinary->getBinaryStatus(XBinary::BSTATUS_ENTROPY, nOffset, nSize, m_pPdStructSignature);
 }
 
 bool Binary_Script::isZeroFilled(qint64 nOffset, qint64 nSize)
@@ -398,39 +441,39 @@ bool Binary_Script::isZeroFilled(qint64 nOffset, qint64 nSize)
         return false;
     }
 
-    return m_pBinary->isZeroFilled(nOffset, nSize, m_pPdStruct);
+    return m_pBinary->isZeroFilled(nOffset, nSize, m_pPdStructSignature);
 }
 
 QString Binary_Script::calculateMD5(qint64 nOffset, qint64 nSize)
 {
-    return m_pBinary->getHash(XBinary::HASH_MD5, nOffset, nSize, m_pPdStruct);
+    return m_pBinary->getHash(XBinary::HASH_MD5, nOffset, nSize, m_pPdStructSignature);
 }
 
 quint32 Binary_Script::calculateCRC32(qint64 nOffset, qint64 nSize)
 {
-    return m_pBinary->_getCRC32(nOffset, nSize, 0, m_pBinary->_getCRC32Table_EDB88320(), m_pPdStruct);
+    return m_pBinary->_getCRC32(nOffset, nSize, 0, m_pBinary->_getCRC32Table_EDB88320(), m_pPdStructSignature);
 }
 
 quint16 Binary_Script::crc16(qint64 nOffset, qint64 nSize, quint16 nInit)
 {
-    return m_pBinary->_getCRC16(nOffset, nSize, nInit, m_pPdStruct);
+    return m_pBinary->_getCRC16(nOffset, nSize, nInit, m_pPdStructSignature);
 }
 
 quint32 Binary_Script::crc32(qint64 nOffset, qint64 nSize, quint32 nInit)
 {
-    return m_pBinary->_getCRC32(nOffset, nSize, nInit, m_pBinary->_getCRC32Table_EDB88320(), m_pPdStruct);
+    return m_pBinary->_getCRC32(nOffset, nSize, nInit, m_pBinary->_getCRC32Table_EDB88320(), m_pPdStructSignature);
 }
 
 quint32 Binary_Script::adler32(qint64 nOffset, qint64 nSize)
 {
-    return m_pBinary->getAdler32(nOffset, nSize, m_pPdStruct);
+    return m_pBinary->getAdler32(nOffset, nSize, m_pPdStructSignature);
 }
 
 bool Binary_Script::isSignatureInSectionPresent(quint32 nNumber, const QString &sSignature)
 {
     bool bResult = false;
 
-    QElapsedTimer *pTimer = _startProfiling();
+    qint64 nProfilingStart = _startProfiling();
 
     qint32 _nNumber = nNumber;
     QString sClassName = metaObject()->className();
@@ -439,10 +482,10 @@ bool Binary_Script::isSignatureInSectionPresent(quint32 nNumber, const QString &
         _nNumber++;
     }
 
-    bResult = m_pBinary->isSignatureInFilePartPresent(&m_memoryMap, _nNumber, sSignature, m_pPdStruct);
+    bResult = m_pBinary->isSignatureInFilePartPresent(&m_memoryMap, _nNumber, sSignature, m_pPdStructSignature);
 
-    if (pTimer) {
-        _finishProfiling(pTimer, QString("isSignatureInSectionPresent[%1]: %2 ").arg(sSignature, QString::number(nNumber)));
+    if (nProfilingStart != -1) {
+        _finishProfiling(nProfilingStart, "isSignatureInSectionPresent", sSignature);
     }
 
     return bResult;
@@ -656,7 +699,7 @@ qint64 Binary_Script::find_ansiString(qint64 nOffset, qint64 nSize, const QStrin
 {
     qint64 nResult = -1;
 
-    nResult = m_pBinary->find_ansiString(nOffset, nSize, sString, m_pPdStruct);
+    nResult = m_pBinary->find_ansiString(nOffset, nSize, sString, m_pPdStructSignature);
 
     return nResult;
 }
@@ -665,7 +708,7 @@ qint64 Binary_Script::find_unicodeString(qint64 nOffset, qint64 nSize, const QSt
 {
     qint64 nResult = -1;
 
-    nResult = m_pBinary->find_unicodeString(nOffset, nSize, sString, m_bIsBigEndian, m_pPdStruct);
+    nResult = m_pBinary->find_unicodeString(nOffset, nSize, sString, m_bIsBigEndian, m_pPdStructSignature);
 
     return nResult;
 }
@@ -674,7 +717,7 @@ qint64 Binary_Script::find_utf8String(qint64 nOffset, qint64 nSize, const QStrin
 {
     qint64 nResult = -1;
 
-    nResult = m_pBinary->find_utf8String(nOffset, nSize, sString, m_pPdStruct);
+    nResult = m_pBinary->find_utf8String(nOffset, nSize, sString, m_pPdStructSignature);
 
     return nResult;
 }
@@ -909,25 +952,33 @@ void Binary_Script::_fixOffsetAndSize(qint64 *pnOffset, qint64 *pnSize)
     }
 }
 
-QElapsedTimer *Binary_Script::_startProfiling()
+qint64 Binary_Script::_startProfiling()
 {
-    QElapsedTimer *pResult = nullptr;
+    qint64 nResult = -1;
 
-    if (m_scanOptions.bIsProfiling) {
-        pResult = new QElapsedTimer;
-        pResult->start();
+    if (m_scanOptions.bIsProfiling || m_scanOptions.pProfiler) {
+        nResult = m_profilingTimer.nsecsElapsed();
     }
 
-    return pResult;
+    return nResult;
 }
 
-void Binary_Script::_finishProfiling(QElapsedTimer *pElapsedTimer, const QString &sInfo)
+void Binary_Script::_finishProfiling(qint64 nStartNs, const QString &sApi, const QString &sArgument, qint64 nOffset, qint64 nSize)
 {
+    qint64 nElapsedNs = m_profilingTimer.nsecsElapsed() - nStartNs;
+
+    if (m_scanOptions.pProfiler) {
+        m_scanOptions.pProfiler->addSample(XScanProfiler::CATEGORY_API, sApi, nElapsedNs);
+    }
+
     if (m_scanOptions.bIsProfiling) {
-        qint64 nElapsed = pElapsedTimer->elapsed();
-        delete pElapsedTimer;
+        QString sInfo = QString("%1[%2]:").arg(sApi, sArgument);
+
+        if (nOffset != -1) {
+            sInfo += QString(" %1 %2").arg(XBinary::valueToHexEx(nOffset), XBinary::valueToHexEx(nSize));
+        }
 
-        emit warningMessage(QString("%1 [%2 ms]").arg(sInfo).arg(QString::number(nElapsed)));
+        emit warningMessage(QString("%1 [%2 ms]").arg(sInfo).arg(QString::number(nElapsedNs / 1000000)));
     }
 }
 
@@ -951,11 +1002,9 @@ qint64 Binary_Script::startTiming()
 {
     quint32 nResult = 0;
 
-    QElapsedTimer *pElapsedTimer = _startProfiling();
-
     nResult = XBinary::random32();
 
-    m_mapProfiling.insert(nResult, pElapsedTimer);
+    m_mapProfiling.insert(nResult, _startProfiling());
 
     return nResult;
 }
@@ -965,9 +1014,19 @@ qint64 Binary_Script::endTiming(qint64 nHandle, const QString &sInfo)
     qint64 nResult = 0;
 
     if (m_mapProfiling.contains(nHandle)) {
-        QElapsedTimer *pElapsedTimer = m_mapProfiling.value(nHandle);
+        qint64 nStartNs = m_mapProfiling.value(nHandle);
+
+        if (nStartNs != -1) {
+            qint64 nElapsedNs = m_profilingTimer.nsecsElapsed() - nStartNs;
+
+            if (m_scanOptions.pProfiler) {
+                m_scanOptions.pProfiler->addSample(XScanProfiler::CATEGORY_TIMING, sInfo, nElapsedNs);
+            }
 
-        _finishProfiling(pElapsedTimer, sInfo);
+            if (m_scanOptions.bIsProfiling) {
+                emit warningMessage(QString("%1 [%2 ms]").arg(sInfo).arg(QString::number(nElapsedNs / 1000000)));
+            }
+        }
 
         m_mapProfiling.remove(nHandle);
     } else {
@@ -979,7 +1038,7 @@ qint64 Binary_Script::endTiming(qint64 nHandle, const QString &sInfo)
 
 qint64 Binary_Script::detectZLIB(qint64 nOffset, qint64 nSize)
 {
-    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_ZLIB, m_pBinary->getDevice(), false, -1, m_pPdStruct, nOffset, nSize);
+    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_ZLIB, m_pBinary->getDevice(), false, -1, m_pPdStructSignature, nOffset, nSize);
 
     if (nResult) {
         return nResult;
@@ -990,7 +1049,7 @@ qint64 Binary_Script::detectZLIB(qint64 nOffset, qint64 nSize)
 
 qint64 Binary_Script::detectGZIP(qint64 nOffset, qint64 nSize)
 {
-    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_GZIP, m_pBinary->getDevice(), false, -1, m_pPdStruct, nOffset, nSize);
+    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_GZIP, m_pBinary->getDevice(), false, -1, m_pPdStructSignature, nOffset, nSize);
 
     if (nResult) {
         return nResult;
@@ -1001,7 +1060,7 @@ qint64 Binary_Script::detectGZIP(qint64 nOffset, qint64 nSize)
 
 qint64 Binary_Script::detectZIP(qint64 nOffset, qint64 nSize)
 {
-    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_ZIP, m_pBinary->getDevice(), false, -1, m_pPdStruct, nOffset, nSize);
+    qint64 nResult = XFormats::getFileFormatSize(XBinary::FT_ZIP, m_pBinary->getDevice(), false, -1, m_pPdStructSignature, nOffset, nSize);
 
     if (nResult) {
         return nResult;
@@ -1030,15 +1089,40 @@ bool Binary_Script::isFilePart()
     return (m_filePart != XBinary::FILEPART_HEADER);
 }
 
+void Binary_Script::startSignature()
+{
+    // A previous signature without finishSignature must not leave its watch behind
+    finishSignature();
+
+    if (m_scanOptions.pWatchdog && (m_scanOptions.nSignatureTimeout > 0)) {
+        m_pdStructSignature = XBinary::createPdStruct();
+        m_pPdStructSignature = &m_pdStructSignature;
+        m_nSignatureWatch = m_scanOptions.pWatchdog->add(&m_pdStructSignature, m_pPdStruct, m_scanOptions.nSignatureTimeout);
+    }
+}
+
+bool Binary_Script::finishSignature()
+{
+    bool bResult = false;
+
+    if (m_nSignatureWatch != -1) {
+        bResult = m_scanOptions.pWatchdog->remove(m_nSignatureWatch);
+        m_nSignatureWatch = -1;
+        m_pPdStructSignature = m_pPdStruct;
+    }
+
+    return bResult;
+}
+
 QList<QVariant> Binary_Script::readBytes(qint64 nOffset, qint64 nSize, bool bReplaceZeroWithSpace)
 {
     QList<QVariant> listResult;
 
-    QByteArray baData = m_pBinary->read_array_process(nOffset, nSize, m_pPdStruct);
+    QByteArray baData = m_pBinary->read_array_process(nOffset, nSize, m_pPdStructSignature);
     qint32 _nSize = baData.size();
     listResult.reserve(_nSize);
 
-    for (qint32 i = 0; (i < _nSize) && XBinary::isPdStructNotCanceled(m_pPdStruct); i++) {
+    for (qint32 i = 0; (i < _nSize) && XBinary::isPdStructNotCanceled(m_pPdStructSignature); i++) {
         if (bReplaceZeroWithSpace && baData.at(i) == 0) {
             listResult.append(32);
         } else {
@@ -1057,11 +1141,11 @@ QList<QVariant> Binary_Script::decompressBytes(qint64 nOffset, qint64 nSize, QSt
     XBinary::HANDLE_METHOD compressionMethod = XBinary::ftStringToHandleMethod(sCompressionMethod);
 
     if (compressionMethod != XBinary::HANDLE_METHOD_UNKNOWN) {
-        QByteArray baData = XDecompress().decomressToByteArray(m_pBinary->getDevice(), nOffset, nSize, compressionMethod, m_pPdStruct);
+        QByteArray baData = XDecompress().decomressToByteArray(m_pBinary->getDevice(), nOffset, nSize, compressionMethod, m_pPdStructSignature);
         qint32 _nSize = baData.size();
         listResult.reserve(_nSize);
 
-        for (qint32 i = 0; (i < _nSize) && XBinary::isPdStructNotCanceled(m_pPdStruct); i++) {
+        for (qint32 i = 0; (i < _nSize) && XBinary::isPdStructNotCanceled(m_pPdStructSignature); i++) {
             quint32 nRecord = (quint8)(baData.at(i));
             listResult.append(nRecord);
         }
@@ -1079,7 +1163,7 @@ qint64 Binary_Script::getCompressedDataSize(qint64 nOffset, qint64 nSize, QStrin
     XBinary::HANDLE_METHOD compressionMethod = XBinary::ftStringToHandleMethod(sCompressionMethod);
 
     if (compressionMethod != XBinary::HANDLE_METHOD_UNKNOWN) {
-        nResult = XDecompress().getCompressedDataSize(m_pBinary->getDevice(), nOffset, nSize, compressionMethod, m_pPdStruct);
+        nResult = XDecompress().getCompressedDataSize(m_pBinary->getDevice(), nOffset, nSize, compressionMethod, m_pPdStructSignature);
     } else {
         emit errorMessage(QString("%1: %2").arg(tr("Unknown compression method")).arg(sCompressionMethod));
     }
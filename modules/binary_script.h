@@ -21,9 +21,14 @@
 #ifndef BINARY_SCRIPT_H
 #define BINARY_SCRIPT_H
 
+#include <QBitArray>
+
 #include "xformats.h"
 #include "xdecompress.h"
 #include "xdisasmcore.h"
+#include "xscanparsecache.h"
+#include "xscanprofiler.h"
+#include "xscanwatchdog.h"
 
 class Binary_Script : public QObject {
     Q_OBJECT
@@ -40,12 +45,28 @@ public:
         bool bIsArchivesScan;
         bool bIsVerbose;
         bool bIsProfiling;
+        XScanProfiler *pProfiler;        // Optional, structured timings
+        XScanParseCache *pParseCache;  // Optional, memory map and format info shared with the other passes over the device
+        XScanWatchdog *pWatchdog;      // Optional, enforces nSignatureTimeout
+        qint32 nSignatureTimeout;      // ms, 0: no limit
         QString sScanID;
     };
 
     explicit Binary_Script(XBinary *pBinary, XBinary::FILEPART filePart, const OPTIONS &scanOptions, XBinary::PDSTRUCT *pPdStruct);
     ~Binary_Script();
 
+    // Bytes behind the cached header/EP/overlay signatures, not visible to scripts
+    QByteArray getHeaderBytes();
+    QByteArray getEntryPointBytes();
+    QByteArray getOverlayBytes();
+    // Set by XScanEngine::getSignatureCandidates in verify mode
+    void setLiteralCandidates(const QBitArray &baCandidates);
+    QBitArray getLiteralCandidates();
+
+    // Called by the engine around each signature; searches and reads of the script API stop when OPTIONS::nSignatureTimeout runs out
+    void startSignature();
+    bool finishSignature();  // true if the signature ran out of time, its result is partial
+
 public slots:
     qint64 getSize();
     bool compare(const QString &sSignature, qint64 nOffset = 0);
@@ -257,8 +278,8 @@ public slots:
 
 private:
     void _fixOffsetAndSize(qint64 *pnOffset, qint64 *pnSize);
-    QElapsedTimer *_startProfiling();
-    void _finishProfiling(QElapsedTimer *pElapsedTimer, const QString &sInfo);
+    qint64 _startProfiling();  // -1 if profiling is off
+    void _finishProfiling(qint64 nStartNs, const QString &sApi, const QString &sArgument, qint64 nOffset = -1, qint64 nSize = -1);
     bool _loadFmtChecking(bool bDeep, XBinary::PDSTRUCT *pPdStruct);
 
 protected:
@@ -277,6 +298,9 @@ private:
     XBinary::FILEPART m_filePart;
     OPTIONS m_scanOptions;
     XBinary::PDSTRUCT *m_pPdStruct;
+    XBinary::PDSTRUCT *m_pPdStructSignature;  // m_pPdStruct or &m_pdStructSignature; lazily loaded members keep m_pPdStruct
+    XBinary::PDSTRUCT m_pdStructSignature;
+    qint32 m_nSignatureWatch;  // -1: no budget
     XBinary::_MEMORY_MAP m_memoryMap;
     XADDR m_nBaseAddress;
     XDisasmAbstract::DISASM_OPTIONS m_disasmOptions;
@@ -292,6 +316,7 @@ private:
     QString m_sEntryPointSignature;
     qint32 m_nEntryPointSignatureSize;
     QString m_sOverlaySignature;
+    QBitArray m_baLiteralCandidates;
     qint32 m_nOverlaySignatureSize;
     bool m_bIsPlainText = false;
     bool m_bIsUTF8Text = false;
@@ -310,7 +335,8 @@ private:
     QList<QString> m_listFormatMessages;
     bool m_bIsBigEndian;
     bool m_bIsSigned;
-    QMap<quint32, QElapsedTimer *> m_mapProfiling;
+    QMap<quint32, qint64> m_mapProfiling;
+    QElapsedTimer m_profilingTimer;
 };
 
 #endif  // BINARY_SCRIPT_H
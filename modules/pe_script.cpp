@@ -25,37 +25,28 @@ PE_Script::PE_Script(XPE *pPE, XBinary::FILEPART filePart, const OPTIONS &scanOp
     m_pPE = pPE;
 
     m_nNumberOfSections = m_pPE->getFileHeader_NumberOfSections();
-    m_listSectionHeaders = m_pPE->getSectionHeaders(getPdStruct());
-    m_listSectionRecords = m_pPE->getSectionRecords(&m_listSectionHeaders, getPdStruct());
-    m_listSectionNameStrings = m_pPE->getSectionNames(&m_listSectionRecords, getPdStruct());
 
-    // Obsolete: .NET/CLI analysis has moved to the DOTNET class (XCLIAssembly).
-    // Kept for backward compatibility with existing signatures.
-    m_pCliAssembly = m_pPE->getCliAssembly(getPdStruct());
+    // Parse results below are loaded on first access by the _load*() helpers and kept for the rest of the scan
+    m_bIsSectionsLoaded = false;
+    m_bIsCliLoaded = false;
+    m_bIsResourcesLoaded = false;
+    m_bIsImportsLoaded = false;
+    m_bIsImportRecordsLoaded = false;
+    m_bIsExportsLoaded = false;
+    m_bIsDebugRecordsLoaded = false;
+
+    m_pCliAssembly = nullptr;
     m_cliInfo = {};
     m_bNetGlobalCctorPresent = false;
+    m_bIsNETPresent = false;
+    m_nNumberOfResources = 0;
+    m_resourcesVersion = {};
+    m_nNumberOfImports = 0;
+    m_exportHeader = {};
+    m_nNumberOfExportFunctions = 0;
+    m_nImportHash64 = 0;
+    m_nImportHash32 = 0;
 
-    if (m_pCliAssembly) {
-        m_cliInfo = m_pCliAssembly->getCliInfo(true, getPdStruct());
-        m_bNetGlobalCctorPresent = m_pCliAssembly->isNetGlobalCctorPresent(&m_cliInfo, getPdStruct());
-
-        if (m_cliInfo.bValid) {
-            m_listNetAnsiStrings = m_pCliAssembly->getAnsiStrings(&m_cliInfo, getPdStruct());
-            m_listNetUnicodeStrings = m_pCliAssembly->getUnicodeStrings(&m_cliInfo, getPdStruct());
-            m_sNetModuleName = m_pCliAssembly->getMetadataModuleName(&m_cliInfo, 0);
-            m_sNetAssemblyName = m_pCliAssembly->getMetadataAssemblyName(&m_cliInfo, 0);
-        }
-    }
-
-    m_listResourceRecords = m_pPE->getResources(getMemoryMap(), 10000, getPdStruct());
-    m_resourcesVersion = m_pPE->getResourcesVersion(&m_listResourceRecords, getPdStruct());
-    m_nNumberOfResources = m_listResourceRecords.count();
-    m_listImportHeaders = m_pPE->getImports(getMemoryMap(), getPdStruct());
-    m_listImportRecords = m_pPE->getImportRecords(getMemoryMap(), getPdStruct());
-
-    m_nNumberOfImports = m_listImportHeaders.count();
-
-    m_bIsNETPresent = (m_pPE->isNETPresent()) && (m_cliInfo.bValid);
     m_bIs32 = m_pPE->is32(getMemoryMap());
     m_bIs64 = m_pPE->is64(getMemoryMap());
     m_bIsDll = m_pPE->isDll();
@@ -82,22 +73,8 @@ PE_Script::PE_Script(XPE *pPE, XBinary::FILEPART filePart, const OPTIONS &scanOp
     m_sCompilerVersion = QString("%1.%2").arg(QString::number(m_nMajorLinkerVersion)).arg(QString::number(m_nMinorLinkerVersion));
     m_sGeneralOptions = QString("%1%2").arg(m_pPE->getTypeAsString()).arg(m_bIs64 ? ("64") : ("32"));
 
-    m_sFileVersion = m_pPE->getFileVersion(&m_resourcesVersion);
-    m_sFileVersionMS = m_pPE->getFileVersionMS(&m_resourcesVersion);
-
     m_nCalculateSizeOfHeaders = m_pPE->calculateHeadersSize();
 
-    m_exportHeader = m_pPE->getExport(false, getPdStruct());
-    m_nNumberOfExportFunctions = m_exportHeader.listPositions.count();
-
-    m_listExportFunctionNameStrings = m_pPE->getExportFunctionsList(&m_exportHeader, getPdStruct());
-
-    m_nImportHash64 = m_pPE->getImportHash64(&m_listImportRecords, getPdStruct());
-    m_nImportHash32 = m_pPE->getImportHash32(&m_listImportRecords, getPdStruct());
-    m_listImportPositionHashes = m_pPE->getImportPositionHashes(&m_listImportHeaders);
-
-    m_listDebugRecords = m_pPE->getDebugList(getPdStruct());
-
     m_imageFileHeader = m_pPE->getFileHeader();
     m_imageOptionalHeader32 = {};
     m_imageOptionalHeader64 = {};
@@ -114,75 +91,233 @@ PE_Script::~PE_Script()
     delete m_pCliAssembly;
 }
 
+void PE_Script::loadAll()
+{
+    _loadSections();
+    _loadCli();
+    _loadResources();
+    _loadImports();
+    _loadImportRecords();
+    _loadExports();
+    _loadDebugRecords();
+}
+
+void PE_Script::_loadSections()
+{
+    if (!m_bIsSectionsLoaded) {
+        m_bIsSectionsLoaded = true;
+        m_listSectionHeaders = m_pPE->getSectionHeaders(getPdStruct());
+        m_listSectionRecords = m_pPE->getSectionRecords(&m_listSectionHeaders, getPdStruct());
+        m_listSectionNameStrings = m_pPE->getSectionNames(&m_listSectionRecords, getPdStruct());
+    }
+}
+
+void PE_Script::_loadCli()
+{
+    // Obsolete: .NET/CLI analysis has moved to the DOTNET class (XCLIAssembly).
+    // Kept for backward compatibility with existing signatures.
+    if (!m_bIsCliLoaded) {
+        m_bIsCliLoaded = true;
+        m_pCliAssembly = m_pPE->getCliAssembly(getPdStruct());
+
+        if (m_pCliAssembly) {
+            m_cliInfo = m_pCliAssembly->getCliInfo(true, getPdStruct());
+            m_bNetGlobalCctorPresent = m_pCliAssembly->isNetGlobalCctorPresent(&m_cliInfo, getPdStruct());
+
+            if (m_cliInfo.bValid) {
+                m_listNetAnsiStrings = m_pCliAssembly->getAnsiStrings(&m_cliInfo, getPdStruct());
+                m_listNetUnicodeStrings = m_pCliAssembly->getUnicodeStrings(&m_cliInfo, getPdStruct());
+                m_sNetModuleName = m_pCliAssembly->getMetadataModuleName(&m_cliInfo, 0);
+                m_sNetAssemblyName = m_pCliAssembly->getMetadataAssemblyName(&m_cliInfo, 0);
+            }
+        }
+
+        m_bIsNETPresent = (m_pPE->isNETPresent()) && (m_cliInfo.bValid);
+    }
+}
+
+void PE_Script::_loadResources()
+{
+    if (!m_bIsResourcesLoaded) {
+        m_bIsResourcesLoaded = true;
+        m_listResourceRecords = m_pPE->getResources(getMemoryMap(), 10000, getPdStruct());
+        m_resourcesVersion = m_pPE->getResourcesVersion(&m_listResourceRecords, getPdStruct());
+        m_nNumberOfResources = m_listResourceRecords.count();
+        m_sFileVersion = m_pPE->getFileVersion(&m_resourcesVersion);
+        m_sFileVersionMS = m_pPE->getFileVersionMS(&m_resourcesVersion);
+    }
+}
+
+void PE_Script::_loadImports()
+{
+    if (!m_bIsImportsLoaded) {
+        m_bIsImportsLoaded = true;
+        m_listImportHeaders = m_pPE->getImports(getMemoryMap(), getPdStruct());
+        m_nNumberOfImports = m_listImportHeaders.count();
+        m_listImportPositionHashes = m_pPE->getImportPositionHashes(&m_listImportHeaders);
+
+        // Per-scan indexes for the library and function lookups; the XPE list helpers are linear per call
+        for (qint32 i = 0; (i < m_nNumberOfImports) && XBinary::isPdStructNotCanceled(getPdStruct()); i++) {
+            const XPE::IMPORT_HEADER &importHeader = m_listImportHeaders.at(i);
+            QString sLibraryNameUpper = importHeader.sName.toUpper();
+
+            m_stImportLibraries.insert(importHeader.sName);
+            m_stImportLibrariesUpper.insert(sLibraryNameUpper);
+
+            QSet<QString> &stFunctions = m_mapImportFunctions[sLibraryNameUpper];
+            QSet<quint32> &stOrdinals = m_mapImportOrdinals[sLibraryNameUpper];
+
+            qint32 nNumberOfPositions = importHeader.listPositions.count();
+
+            for (qint32 j = 0; j < nNumberOfPositions; j++) {
+                const XPE::IMPORT_POSITION &importPosition = importHeader.listPositions.at(j);
+
+                stFunctions.insert(importPosition.sFunction);
+                m_stImportFunctions.insert(importPosition.sFunction);
+
+                if (importPosition.sName.isEmpty()) {
+                    stOrdinals.insert((quint32)importPosition.nOrdinal);
+                }
+            }
+        }
+    }
+}
+
+void PE_Script::_loadImportRecords()
+{
+    if (!m_bIsImportRecordsLoaded) {
+        m_bIsImportRecordsLoaded = true;
+        m_listImportRecords = m_pPE->getImportRecords(getMemoryMap(), getPdStruct());
+        m_nImportHash64 = m_pPE->getImportHash64(&m_listImportRecords, getPdStruct());
+        m_nImportHash32 = m_pPE->getImportHash32(&m_listImportRecords, getPdStruct());
+    }
+}
+
+void PE_Script::_loadExports()
+{
+    if (!m_bIsExportsLoaded) {
+        m_bIsExportsLoaded = true;
+        m_exportHeader = m_pPE->getExport(false, getPdStruct());
+        m_nNumberOfExportFunctions = m_exportHeader.listPositions.count();
+        m_listExportFunctionNameStrings = m_pPE->getExportFunctionsList(&m_exportHeader, getPdStruct());
+
+        qint32 nNumberOfNames = m_listExportFunctionNameStrings.count();
+
+        for (qint32 i = 0; i < nNumberOfNames; i++) {
+            m_stExportFunctionNames.insert(m_listExportFunctionNameStrings.at(i));
+        }
+
+        for (qint32 i = 0; i < m_nNumberOfExportFunctions; i++) {
+            m_stExportOrdinals.insert(m_exportHeader.listPositions.at(i).nOrdinal);
+        }
+    }
+}
+
+void PE_Script::_loadDebugRecords()
+{
+    if (!m_bIsDebugRecordsLoaded) {
+        m_bIsDebugRecordsLoaded = true;
+        m_listDebugRecords = m_pPE->getDebugList(getPdStruct());
+    }
+}
+
 // Obsolete: .NET/CLI analysis has moved to the DOTNET class (XCLIAssembly).
 // The functions below are kept for backward compatibility with existing signatures.
 bool PE_Script::isNETStringPresent(const QString &sString)
 {
+    _loadCli();
+
     return XBinary::isStringInListPresent(&m_listNetAnsiStrings, sString, getPdStruct());
 }
 
 bool PE_Script::isNetObjectPresent(const QString &sString)
 {
+    _loadCli();
+
     return XBinary::isStringInListPresent(&m_listNetAnsiStrings, sString, getPdStruct());
 }
 
 bool PE_Script::isNETUnicodeStringPresent(const QString &sString)
 {
+    _loadCli();
+
     return XBinary::isStringInListPresent(&m_listNetUnicodeStrings, sString, getPdStruct());
 }
 
 bool PE_Script::isNetUStringPresent(const QString &sString)
 {
+    _loadCli();
+
     return XBinary::isStringInListPresent(&m_listNetUnicodeStrings, sString, getPdStruct());
 }
 
 qint64 PE_Script::findSignatureInBlob_NET(const QString &sSignature)
 {
+    _loadCli();
+
     return m_pCliAssembly->findSignatureInBlob_NET(sSignature, getPdStruct());
 }
 
 bool PE_Script::isSignatureInBlobPresent_NET(const QString &sSignature)
 {
+    _loadCli();
+
     return m_pCliAssembly->isSignatureInBlobPresent_NET(sSignature, getPdStruct());
 }
 
 bool PE_Script::isNetGlobalCctorPresent()
 {
+    _loadCli();
+
     return m_bNetGlobalCctorPresent;
 }
 
 bool PE_Script::isNetTypePresent(const QString &sTypeNamespace, const QString &sTypeName)
 {
+    _loadCli();
+
     return m_pCliAssembly->isNetTypePresent(&m_cliInfo, sTypeNamespace, sTypeName, getPdStruct());
 }
 
 bool PE_Script::isNetMethodPresent(const QString &sTypeNamespace, const QString &sTypeName, const QString &sMethodName)
 {
+    _loadCli();
+
     return m_pCliAssembly->isNetMethodPresent(&m_cliInfo, sTypeNamespace, sTypeName, sMethodName, getPdStruct());
 }
 
 bool PE_Script::isNetFieldPresent(const QString &sTypeNamespace, const QString &sTypeName, const QString &sFieldName)
 {
+    _loadCli();
+
     return m_pCliAssembly->isNetFieldPresent(&m_cliInfo, sTypeNamespace, sTypeName, sFieldName, getPdStruct());
 }
 
 QString PE_Script::getNetModuleName()
 {
+    _loadCli();
+
     return m_sNetModuleName;
 }
 
 QString PE_Script::getNetAssemblyName()
 {
+    _loadCli();
+
     return m_sNetAssemblyName;
 }
 
 QString PE_Script::getNETVersion()
 {
+    _loadCli();
+
     return m_cliInfo.metaData.header.sVersion;
 }
 
 bool PE_Script::compareEP_NET(const QString &sSignature, qint64 nOffset)
 {
+    _loadCli();
+
     return m_pPE->compareSignatureOnAddress(getMemoryMap(), sSignature, getBaseAddress() + m_cliInfo.metaData.nEntryPoint + nOffset);
 }
 
@@ -193,51 +328,71 @@ quint16 PE_Script::getNumberOfSections()
 
 QString PE_Script::getSectionName(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_NameAsString(nNumber, &m_listSectionNameStrings);
 }
 
 quint32 PE_Script::getSectionVirtualSize(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_VirtualSize(nNumber, &m_listSectionHeaders);
 }
 
 quint32 PE_Script::getSectionVirtualAddress(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_VirtualAddress(nNumber, &m_listSectionHeaders);
 }
 
 quint32 PE_Script::getSectionFileSize(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_SizeOfRawData(nNumber, &m_listSectionHeaders);
 }
 
 quint32 PE_Script::getSectionFileOffset(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_PointerToRawData(nNumber, &m_listSectionHeaders);
 }
 
 quint32 PE_Script::getSectionCharacteristics(quint32 nNumber)
 {
+    _loadSections();
+
     return m_pPE->getSection_Characteristics(nNumber, &m_listSectionHeaders);
 }
 
 quint32 PE_Script::getNumberOfResources()
 {
+    _loadResources();
+
     return m_nNumberOfResources;
 }
 
 bool PE_Script::isSectionNamePresent(const QString &sSectionName)
 {
+    _loadSections();
+
     return XBinary::isStringInListPresent(&m_listSectionNameStrings, sSectionName, getPdStruct());
 }
 
 bool PE_Script::_isSectionNamePresentExp(const QString &sSectionName)
 {
+    _loadSections();
+
     return XBinary::isStringInListPresentExp(&m_listSectionNameStrings, sSectionName, getPdStruct());
 }
 
 bool PE_Script::isNet()
 {
+    _loadCli();
+
     return m_bIsNETPresent;
 }
 
@@ -258,47 +413,63 @@ QString PE_Script::getGeneralOptions()
 
 quint32 PE_Script::getResourceIdByNumber(quint32 nNumber)
 {
+    _loadResources();
+
     return m_pPE->getResourceIdByNumber(nNumber, &m_listResourceRecords);
 }
 
 QString PE_Script::getResourceNameByNumber(quint32 nNumber)
 {
+    _loadResources();
+
     return m_pPE->getResourceNameByNumber(nNumber, &m_listResourceRecords);
 }
 
 qint64 PE_Script::getResourceOffsetByNumber(quint32 nNumber)
 {
+    _loadResources();
+
     return m_pPE->getResourceOffsetByNumber(nNumber, &m_listResourceRecords);
 }
 
 qint64 PE_Script::getResourceSizeByNumber(quint32 nNumber)
 {
+    _loadResources();
+
     return m_pPE->getResourceSizeByNumber(nNumber, &m_listResourceRecords);
 }
 
 quint32 PE_Script::getResourceTypeByNumber(quint32 nNumber)
 {
+    _loadResources();
+
     return m_pPE->getResourceTypeByNumber(nNumber, &m_listResourceRecords);
 }
 
 qint32 PE_Script::getNumberOfImports()
 {
+    _loadImports();
+
     return m_nNumberOfImports;
 }
 
 QString PE_Script::getImportLibraryName(quint32 nNumber)
 {
+    _loadImports();
+
     return m_pPE->getImportLibraryName(nNumber, &m_listImportHeaders);
 }
 
 bool PE_Script::isLibraryPresent(const QString &sLibraryName, bool bCheckCase)
 {
+    _loadImports();
+
     bool bResult = false;
 
     if (bCheckCase) {
-        bResult = m_pPE->isImportLibraryPresent(sLibraryName, &m_listImportHeaders, getPdStruct());
+        bResult = m_stImportLibraries.contains(sLibraryName);
     } else {
-        bResult = m_pPE->isImportLibraryPresentI(sLibraryName, &m_listImportHeaders, getPdStruct());
+        bResult = m_stImportLibrariesUpper.contains(sLibraryName.toUpper());
     }
 
     return bResult;
@@ -306,16 +477,29 @@ bool PE_Script::isLibraryPresent(const QString &sLibraryName, bool bCheckCase)
 
 bool PE_Script::isLibraryFunctionPresent(const QString &sLibraryName, const QString &sFunctionName)
 {
-    return m_pPE->isImportFunctionPresentI(sLibraryName, sFunctionName, &m_listImportHeaders, getPdStruct());
+    _loadImports();
+
+    return m_mapImportFunctions.value(sLibraryName.toUpper()).contains(sFunctionName);
+}
+
+bool PE_Script::isLibraryOrdinalPresent(const QString &sLibraryName, quint32 nOrdinal)
+{
+    _loadImports();
+
+    return m_mapImportOrdinals.value(sLibraryName.toUpper()).contains(nOrdinal);
 }
 
 bool PE_Script::isFunctionPresent(const QString &sFunctionName)
 {
-    return m_pPE->isFunctionPresent(sFunctionName, &m_listImportHeaders, getPdStruct());
+    _loadImports();
+
+    return m_stImportFunctions.contains(sFunctionName);
 }
 
 QString PE_Script::getImportFunctionName(quint32 nImport, quint32 nFunctionNumber)
 {
+    _loadImports();
+
     return m_pPE->getImportFunctionName(nImport, nFunctionNumber, &m_listImportHeaders);
 }
 
@@ -361,36 +545,50 @@ quint8 PE_Script::getMinorLinkerVersion()
 
 QString PE_Script::getManifest()
 {
+    _loadResources();
+
     return m_pPE->getResourceManifest(&m_listResourceRecords);
 }
 
 QString PE_Script::getVersionStringInfo(const QString &sKey)
 {
+    _loadResources();
+
     return m_pPE->getResourcesVersionValue(sKey, &m_resourcesVersion);
 }
 
 qint32 PE_Script::getNumberOfImportThunks(quint32 nNumber)
 {
+    _loadImports();
+
     return m_pPE->getNumberOfImportThunks(nNumber, &m_listImportHeaders);
 }
 
 qint64 PE_Script::getResourceNameOffset(const QString &sName)
 {
+    _loadResources();
+
     return m_pPE->getResourceNameOffset(sName, &m_listResourceRecords);
 }
 
 bool PE_Script::isResourceNamePresent(const QString &sName)
 {
+    _loadResources();
+
     return m_pPE->isResourceNamePresent(sName, &m_listResourceRecords);
 }
 
 bool PE_Script::isResourceGroupNamePresent(const QString &sName)
 {
+    _loadResources();
+
     return m_pPE->isResourceGroupNamePresent(sName, &m_listResourceRecords);
 }
 
 bool PE_Script::isResourceGroupIdPresent(quint32 nID)
 {
+    _loadResources();
+
     return m_pPE->isResourceGroupIdPresent(nID, &m_listResourceRecords);
 }
 
@@ -411,16 +609,22 @@ bool PE_Script::isSignedFile()
 
 QString PE_Script::getSectionNameCollision(const QString &sString1, const QString &sString2)
 {
+    _loadSections();
+
     return m_pPE->getStringCollision(&m_listSectionNameStrings, sString1, sString2);
 }
 
 qint32 PE_Script::getSectionNumber(const QString &sSectionName)
 {
+    _loadSections();
+
     return XBinary::getStringNumberFromList(&m_listSectionNameStrings, sSectionName, getPdStruct());
 }
 
 qint32 PE_Script::getSectionNumberExp(const QString &sSectionName)
 {
+    _loadSections();
+
     return XBinary::getStringNumberFromListExp(&m_listSectionNameStrings, sSectionName, getPdStruct());
 }
 
@@ -462,11 +666,15 @@ QString PE_Script::getPEFileVersion(const QString &sFileName)
 
 QString PE_Script::getFileVersion()
 {
+    _loadResources();
+
     return m_sFileVersion;
 }
 
 QString PE_Script::getFileVersionMS()
 {
+    _loadResources();
+
     return m_sFileVersionMS;
 }
 
@@ -477,7 +685,16 @@ qint64 PE_Script::calculateSizeOfHeaders()
 
 bool PE_Script::isExportFunctionPresent(const QString &sFunctionName)
 {
-    return XBinary::isStringInListPresent(&m_listExportFunctionNameStrings, sFunctionName, getPdStruct());
+    _loadExports();
+
+    return m_stExportFunctionNames.contains(sFunctionName);
+}
+
+bool PE_Script::isExportOrdinalPresent(quint32 nOrdinal)
+{
+    _loadExports();
+
+    return m_stExportOrdinals.contains(nOrdinal);
 }
 
 // bool PE_Script::isExportFunctionPresentExp(const QString &sFunctionName)
@@ -487,6 +704,8 @@ bool PE_Script::isExportFunctionPresent(const QString &sFunctionName)
 
 qint32 PE_Script::getNumberOfExportFunctions()
 {
+    _loadExports();
+
     return m_nNumberOfExportFunctions;
 }
 
@@ -497,6 +716,8 @@ qint32 PE_Script::getNumberOfExports()
 
 QString PE_Script::getExportFunctionName(quint32 nNumber)
 {
+    _loadExports();
+
     return m_pPE->getStringByIndex(&m_listExportFunctionNameStrings, nNumber, -1);
 }
 
@@ -527,16 +748,22 @@ bool PE_Script::isResourcesPresent()
 
 quint32 PE_Script::getImportHash32()
 {
+    _loadImportRecords();
+
     return m_nImportHash32;
 }
 
 quint64 PE_Script::getImportHash64()
 {
+    _loadImportRecords();
+
     return m_nImportHash64;
 }
 
 bool PE_Script::isImportPositionHashPresent(qint32 nIndex, quint32 nHash)
 {
+    _loadImports();
+
     return XPE::isImportPositionHashPresent(&m_listImportPositionHashes, nIndex, nHash, getPdStruct());
 }
 
@@ -556,11 +783,15 @@ quint64 PE_Script::getImageOptionalHeader(const QString &sString)
 
 qint32 PE_Script::getNumberOfDebugDataRecords()
 {
+    _loadDebugRecords();
+
     return m_listDebugRecords.count();
 }
 
 QString PE_Script::getDebugDataType(quint32 nNumber)
 {
+    _loadDebugRecords();
+
     QString sResult;
 
     if (nNumber < (quint32)m_listDebugRecords.count()) {
@@ -574,6 +805,8 @@ QString PE_Script::getDebugDataType(quint32 nNumber)
 
 qint64 PE_Script::getDebugDataOffset(quint32 nNumber)
 {
+    _loadDebugRecords();
+
     qint64 nResult = -1;
 
     if (nNumber < (quint32)m_listDebugRecords.count()) {
@@ -585,6 +818,8 @@ qint64 PE_Script::getDebugDataOffset(quint32 nNumber)
 
 qint64 PE_Script::getDebugDataSize(quint32 nNumber)
 {
+    _loadDebugRecords();
+
     qint64 nResult = -1;
 
     if (nNumber < (quint32)m_listDebugRecords.count()) {
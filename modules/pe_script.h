@@ -32,6 +32,8 @@ public:
     explicit PE_Script(XPE *pPE, XBinary::FILEPART filePart, const OPTIONS &scanOptions, XBinary::PDSTRUCT *pPdStruct);
     ~PE_Script();
 
+    void loadAll();  // Parses every lazily loaded member at once
+
 public slots:
     quint16 getNumberOfSections();
     QString getSectionName(quint32 nNumber);
@@ -56,6 +58,7 @@ public slots:
     QString getImportLibraryName(quint32 nNumber);
     bool isLibraryPresent(const QString &sLibraryName, bool bCheckCase = false);
     bool isLibraryFunctionPresent(const QString &sLibraryName, const QString &sFunctionName);
+    bool isLibraryOrdinalPresent(const QString &sLibraryName, quint32 nOrdinal);
     bool isFunctionPresent(const QString &sFunctionName);
     QString getImportFunctionName(quint32 nImport, quint32 nFunctionNumber);
     qint32 getImportSection();
@@ -89,6 +92,7 @@ public slots:
     qint64 calculateSizeOfHeaders();
     bool isExportFunctionPresent(const QString &sFunctionName);
     // bool isExportFunctionPresentExp(const QString &sFunctionName);
+    bool isExportOrdinalPresent(quint32 nOrdinal);
     qint32 getNumberOfExportFunctions();
     qint32 getNumberOfExports();
     QString getExportFunctionName(quint32 nNumber);
@@ -127,7 +131,22 @@ public slots:
     bool compareEP_NET(const QString &sSignature, qint64 nOffset = 0);
 
 private:
+    void _loadSections();
+    void _loadCli();
+    void _loadResources();
+    void _loadImports();
+    void _loadImportRecords();
+    void _loadExports();
+    void _loadDebugRecords();
+
     XPE *m_pPE;
+    bool m_bIsSectionsLoaded;
+    bool m_bIsCliLoaded;
+    bool m_bIsResourcesLoaded;
+    bool m_bIsImportsLoaded;
+    bool m_bIsImportRecordsLoaded;
+    bool m_bIsExportsLoaded;
+    bool m_bIsDebugRecordsLoaded;
     // Obsolete: backing for the compatibility .NET functions
     XCLIAssembly *m_pCliAssembly;
     XCLIAssembly::CLI_INFO m_cliInfo;
@@ -145,6 +164,11 @@ private:
     QList<XPE::IMPORT_HEADER> m_listImportHeaders;
     QList<XPE::IMPORT_RECORD> m_listImportRecords;
     qint32 m_nNumberOfImports;
+    QSet<QString> m_stImportLibraries;
+    QSet<QString> m_stImportLibrariesUpper;
+    QSet<QString> m_stImportFunctions;
+    QHash<QString, QSet<QString>> m_mapImportFunctions;  // Upper-case library name -> function names
+    QHash<QString, QSet<quint32>> m_mapImportOrdinals;   // Upper-case library name -> imported ordinals
     qint32 m_nNumberOfExportFunctions;
     XPE::RESOURCES_VERSION m_resourcesVersion;
     bool m_bIsNETPresent;
@@ -175,6 +199,8 @@ private:
     qint32 m_nCalculateSizeOfHeaders;
     XPE::EXPORT_HEADER m_exportHeader;
     QList<QString> m_listExportFunctionNameStrings;
+    QSet<QString> m_stExportFunctionNames;
+    QSet<quint32> m_stExportOrdinals;
     quint64 m_nImportHash64;
     quint64 m_nImportHash32;
     QList<quint32> m_listImportPositionHashes;
@@ -247,12 +247,17 @@ QString ScanItemModel::toXML()
 }
 
 QString ScanItemModel::toJSON()
+{
+    QJsonDocument saveFormat(toJsonObject());
+    return QString::fromUtf8(saveFormat.toJson(QJsonDocument::Indented));
+}
+
+QJsonObject ScanItemModel::toJsonObject()
 {
     QJsonObject jsonResult;
     _toJSON(&jsonResult, m_pRootItem, 0);
 
-    QJsonDocument saveFormat(jsonResult);
-    return QString::fromUtf8(saveFormat.toJson(QJsonDocument::Indented));
+    return jsonResult;
 }
 
 QString ScanItemModel::toCSV()
@@ -55,6 +55,9 @@ public:
     Qt::ItemFlags flags(const QModelIndex &index) const override;
     QString toXML();
     QString toJSON();
+#if (QT_VERSION_MAJOR > 4)
+    QJsonObject toJsonObject();
+#endif
     QString toCSV();
     QString toTSV();
     QString toFormattedString();
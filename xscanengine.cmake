@@ -1,6 +1,11 @@
 include_directories(${CMAKE_CURRENT_LIST_DIR})
 include_directories(${CMAKE_CURRENT_LIST_DIR}/modules)
 
+# QtConcurrent: parallel database load, directory workers and sub-scans
+find_package(QT NAMES Qt6 Qt5 REQUIRED COMPONENTS Core)
+find_package(Qt${QT_VERSION_MAJOR} REQUIRED COMPONENTS Concurrent)
+link_libraries(Qt${QT_VERSION_MAJOR}::Concurrent)
+
 if (NOT DEFINED XFORMATS_SOURCES)
     include(${CMAKE_CURRENT_LIST_DIR}/../Formats/xformats.cmake)
     set(XSCANENGINE_SOURCES ${XSCANENGINE_SOURCES} ${XFORMATS_SOURCES})
@@ -36,6 +41,16 @@ set(XSCANENGINE_SOURCES
     ${CMAKE_CURRENT_LIST_DIR}/xscanengine.h
     ${CMAKE_CURRENT_LIST_DIR}/xscanengineprocess.cpp
     ${CMAKE_CURRENT_LIST_DIR}/xscanengineprocess.h
+    ${CMAKE_CURRENT_LIST_DIR}/xscanliteralindex.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/xscanliteralindex.h
+    ${CMAKE_CURRENT_LIST_DIR}/xscanparsecache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/xscanparsecache.h
+    ${CMAKE_CURRENT_LIST_DIR}/xscanprofiler.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/xscanprofiler.h
+    ${CMAKE_CURRENT_LIST_DIR}/xscanresultcache.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/xscanresultcache.h
+    ${CMAKE_CURRENT_LIST_DIR}/xscanwatchdog.cpp
+    ${CMAKE_CURRENT_LIST_DIR}/xscanwatchdog.h
     ${CMAKE_CURRENT_LIST_DIR}/scanitem.cpp
     ${CMAKE_CURRENT_LIST_DIR}/scanitem.h
     ${CMAKE_CURRENT_LIST_DIR}/scanitemmodel.cpp
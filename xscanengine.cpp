@@ -19,51 +19,87 @@
  * SOFTWARE.
  */
 #include "xscanengine.h"
+#include "xscanresultcache.h"
 #include <QCryptographicHash>
 #include <QFileInfo>
 #include <QDir>
 #include <QDirIterator>
 #include <QFile>
+#include <QSaveFile>
 #include <QDataStream>
 #include <QStandardPaths>
 #include <QJsonDocument>
 #include <QJsonObject>
 #include <QJsonArray>
 #include <QCryptographicHash>
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QThreadPool>
+#include <QtConcurrent>
 #include <QFileInfo>
 
-bool sort_signature_prio(const XScanEngine::SIGNATURE_RECORD &sr1, const XScanEngine::SIGNATURE_RECORD &sr2)
+#include <iterator>
+
+static const qint64 SIGNATURE_PRIO_NONE = 1;    // Fewer than two dots or an empty section: name order only
+static const qint64 SIGNATURE_PRIO_STRING = 2;  // Section too long to pack, compared as a string
+
+// The section before the extension, "" if the name has fewer than two dots
+static QString getSignaturePrioSection(const QString &sName)
 {
-    if (sr1.fileType != sr2.fileType) {
-        return (sr1.fileType < sr2.fileType);
+    QString sResult;
+
+    qint32 nPos = sName.count(".");
+
+    if (nPos > 1) {
+        sResult = sName.section(".", nPos - 1, nPos - 1);
     }
 
-    // if ((sr1.sName == "_init") && (sr2.sName == "_init")) {
-    //     return false;
-    // }
+    return sResult;
+}
 
-    // if (sr1.sName == "_init") {
-    //     return true;
-    // } else if (sr2.sName == "_init") {
-    //     return false;
-    // }
+// Key for sort_signature_prio: up to 3 UTF-16 units of the section, zero padded, so the keys order like the strings
+static qint64 getSignaturePrio(const QString &sName)
+{
+    qint64 nResult = SIGNATURE_PRIO_NONE;
+
+    QString sPrio = getSignaturePrioSection(sName);
+    qint32 nSize = sPrio.size();
 
-    QString sPrio1 = "9";
-    QString sPrio2 = "9";
+    if (nSize > 3) {
+        nResult = SIGNATURE_PRIO_STRING;
+    } else if (nSize > 0) {
+        nResult = 0;
 
-    qint32 nPos1 = sr1.sName.count(".");
-    qint32 nPos2 = sr2.sName.count(".");
+        for (qint32 i = 0; i < 3; i++) {
+            nResult = (nResult << 16) | ((i < nSize) ? sPrio.at(i).unicode() : 0);
+        }
 
-    if ((nPos1 > 1) && (nPos2 > 1)) {
-        sPrio1 = sr1.sName.section(".", nPos1 - 1, nPos1 - 1);
-        sPrio2 = sr2.sName.section(".", nPos2 - 1, nPos2 - 1);
+        nResult |= ((qint64)1 << 48);
     }
 
-    if ((sPrio1 != "") && (sPrio2 != "")) {
-        if (sPrio1 > sPrio2) {
-            return false;
-        } else if (sPrio1 < sPrio2) {
-            return true;
+    return nResult;
+}
+
+bool sort_signature_prio(const XScanEngine::SIGNATURE_RECORD &sr1, const XScanEngine::SIGNATURE_RECORD &sr2)
+{
+    if (sr1.fileType != sr2.fileType) {
+        return (sr1.fileType < sr2.fileType);
+    }
+
+    // Records built outside the loaders have no key yet
+    qint64 nPrio1 = sr1.nPrio ? sr1.nPrio : getSignaturePrio(sr1.sName);
+    qint64 nPrio2 = sr2.nPrio ? sr2.nPrio : getSignaturePrio(sr2.sName);
+
+    if ((nPrio1 != SIGNATURE_PRIO_NONE) && (nPrio2 != SIGNATURE_PRIO_NONE)) {
+        if ((nPrio1 == SIGNATURE_PRIO_STRING) || (nPrio2 == SIGNATURE_PRIO_STRING)) {
+            QString sPrio1 = getSignaturePrioSection(sr1.sName);
+            QString sPrio2 = getSignaturePrioSection(sr2.sName);
+
+            if (sPrio1 != sPrio2) {
+                return (sPrio1 < sPrio2);
+            }
+        } else if (nPrio1 != nPrio2) {
+            return (nPrio1 < nPrio2);
         }
     }
 
@@ -85,6 +121,73 @@ bool sort_signature_name(const XScanEngine::SIGNATURE_RECORD &sr1, const XScanEn
     return (sr1.sName < sr2.sName);
 }
 
+// Database cache v7: native byte order, every offset is from the start of the file so it can be mapped and used in place
+static const quint32 DBCACHE_MAGIC_MAPPED = 0x44494543;  // "DIEC"
+static const quint32 DBCACHE_FLAG_EP = 0x00000001;
+
+struct DBCACHE_STRING {
+    quint32 nOffset;
+    quint32 nLength;  // UTF-16 code units
+};
+
+struct DBCACHE_HEADER {
+    quint32 nMagic;
+    quint32 nVersion;
+    quint32 nFileCount;
+    quint32 nRecordCount;
+    quint64 nTotalSize;
+    qint64 nNewestMtime;
+    DBCACHE_STRING engineName;
+    quint32 nRecordsOffset;
+    quint32 nStringsOffset;
+    quint32 nStringsSize;
+    quint32 nReserved;
+};
+
+struct DBCACHE_RECORD {
+    qint32 nFileType;
+    qint32 nDatabaseType;
+    qint64 nLine;
+    quint32 nFlags;
+    quint32 nReserved;
+    DBCACHE_STRING sName;
+    DBCACHE_STRING sFilePath;
+    DBCACHE_STRING sText;
+    DBCACHE_STRING sType;
+    DBCACHE_STRING sVersion;
+    DBCACHE_STRING sInfo;
+    DBCACHE_STRING sInitType;
+};
+
+static bool isDatabaseCacheStringValid(const DBCACHE_STRING &string, qint64 nFileSize)
+{
+    return ((string.nOffset % 2) == 0) && (((quint64)string.nOffset + (quint64)string.nLength * 2) <= (quint64)nFileSize);
+}
+
+static QString getDatabaseCacheString(const char *pData, const DBCACHE_STRING &string)
+{
+    QString sResult;
+
+    if (string.nLength) {
+        // No copy: the string references the mapped file until it is modified
+        sResult = QString::fromRawData((const QChar *)(pData + string.nOffset), string.nLength);
+    }
+
+    return sResult;
+}
+
+static DBCACHE_STRING addDatabaseCacheString(QByteArray *pbaStrings, quint32 nStringsOffset, const QString &sString)
+{
+    DBCACHE_STRING result = {};
+
+    result.nOffset = nStringsOffset + pbaStrings->size();
+    result.nLength = sString.size();
+
+    pbaStrings->append((const char *)sString.constData(), sString.size() * 2);
+
+    return result;
+}
+
 static bool isCollectionFileTypeAllowed(const XScanEngine::SCAN_OPTIONS *pScanOptions, XBinary::FT fileType)
 {
     bool bResult = pScanOptions->bCollectionAllFileTypes || pScanOptions->stCollectionFileTypes.isEmpty();
@@ -1159,13 +1262,36 @@ bool _sortItems(const XScanEngine::SCANSTRUCT &v1, const XScanEngine::SCANSTRUCT
     return bResult;
 }
 
+static void detachSignatureRecord(XScanEngine::SIGNATURE_RECORD *pRecord)
+{
+    // Strings of a mapped cache point into the file; copies stay valid when it is unmapped
+    pRecord->sFilePath = QString(pRecord->sFilePath.constData(), pRecord->sFilePath.size());
+    pRecord->sType = QString(pRecord->sType.constData(), pRecord->sType.size());
+    pRecord->sName = QString(pRecord->sName.constData(), pRecord->sName.size());
+    pRecord->sText = QString(pRecord->sText.constData(), pRecord->sText.size());
+    pRecord->sInfo = QString(pRecord->sInfo.constData(), pRecord->sInfo.size());
+    pRecord->sVersion = QString(pRecord->sVersion.constData(), pRecord->sVersion.size());
+    pRecord->sInitType = QString(pRecord->sInitType.constData(), pRecord->sInitType.size());
+}
+
 XScanEngine::XScanEngine(QObject *pParent) : QObject(pParent)
 {
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT);
+    pDatabase->sFingerprint = _getDatabaseFingerprint(pDatabase.data());
+
+    m_pDatabase = pDatabase;
+    m_databaseWatch = {};
+    m_pDatabaseWatcher = nullptr;
+    m_pDatabaseReloadTimer = nullptr;
 }
 
 XScanEngine::XScanEngine(const XScanEngine &other) : QObject(other.parent())
 {
-    m_listSignatures = other.m_listSignatures;
+    // Shares the loaded signatures, nothing is copied
+    m_pDatabase = other._getDatabase();
+    m_databaseWatch = other.m_databaseWatch;
+    m_pDatabaseWatcher = nullptr;
+    m_pDatabaseReloadTimer = nullptr;
 }
 
 QString XScanEngine::databaseStateToJson(const DATABASE_STATE &databaseState)
@@ -1342,128 +1468,123 @@ bool XScanEngine::loadDatabase(SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pP
 {
     bool bResult = false;
 
-    initDatabase();
+    m_databaseWatch.sMainDatabasePath = pScanOptions->sMainDatabasePath;
+    m_databaseWatch.sCustomDatabasePath = pScanOptions->sCustomDatabasePath;
+    m_databaseWatch.bUseCustomDatabase = pScanOptions->bUseCustomDatabase;
+    m_databaseWatch.bUseCache = pScanOptions->bUseCache;
 
-    bResult = loadDatabase(pScanOptions->sMainDatabasePath, DT_MAIN, pScanOptions->bUseCache, pPdStruct);
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT);
 
-    if (pScanOptions->bUseCustomDatabase) {
-        loadDatabase(pScanOptions->sCustomDatabasePath, DT_CUSTOM, pScanOptions->bUseCache, pPdStruct);
-    }
+    bResult = _loadDatabaseSnapshot(pDatabase.data(), pPdStruct);
 
-    loadMetadata(pScanOptions->sMainDatabasePath, pPdStruct);
+    _setDatabase(pDatabase);
 
     return bResult;
 }
 
 bool XScanEngine::_loadDatabase(const QString &sDatabasePath, DT databaseType)
 {
-    return loadDatabase(sDatabasePath, databaseType, false, nullptr);
-}
+    // Appends to a copy, the published snapshot is never changed
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT(*_getDatabase()));
 
-void XScanEngine::initDatabase()
-{
-    m_listSignatures.clear();
-    m_listMetadata.clear();
+    bool bResult = loadDatabase(sDatabasePath, databaseType, false, pDatabase.data(), nullptr);
+
+    _buildLiteralIndex(pDatabase.data());
+    _buildSignatureBuckets(pDatabase.data());
+    _buildMetadataIndex(pDatabase.data());
+
+    _setDatabase(pDatabase);
+
+    return bResult;
 }
 
-void XScanEngine::initMetadata()
+bool XScanEngine::_loadDatabaseSnapshot(DATABASE_SNAPSHOT *pDatabase, XBinary::PDSTRUCT *pPdStruct)
 {
-    m_listMetadata.clear();
+    // Metadata is read together with the signatures of each database
+    bool bResult = loadDatabase(m_databaseWatch.sMainDatabasePath, DT_MAIN, m_databaseWatch.bUseCache, pDatabase, pPdStruct);
+
+    if (m_databaseWatch.bUseCustomDatabase) {
+        loadDatabase(m_databaseWatch.sCustomDatabasePath, DT_CUSTOM, m_databaseWatch.bUseCache, pDatabase, pPdStruct);
+    }
+
+    // Indexes are built before the snapshot is published
+    _buildLiteralIndex(pDatabase);
+    _buildSignatureBuckets(pDatabase);
+    _buildMetadataIndex(pDatabase);
+
+    return bResult;
 }
 
-QList<XScanEngine::METADATA_RECORD> *XScanEngine::getMetadata()
+void XScanEngine::_setDatabase(const QSharedPointer<DATABASE_SNAPSHOT> &pDatabase)
 {
-    return &m_listMetadata;
+    // Hashed once per snapshot and outside the lock; scans key their results on the snapshot they hold
+    pDatabase->sFingerprint = _getDatabaseFingerprint(pDatabase.data());
+
+    QWriteLocker locker(&m_lockDatabase);
+
+    m_pDatabase = pDatabase;
 }
 
-QMap<QString, XBinary::FT> XScanEngine::_getDatabaseFileTypeMap()
+const XScanEngine::DATABASE_SNAPSHOT *XScanEngine::_holdDatabase()
 {
-    QMap<QString, XBinary::FT> mapResult;
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
 
-    mapResult.insert("Binary", XBinary::FT_BINARY);
-    mapResult.insert("COM", XBinary::FT_COM);
-    mapResult.insert("Archive", XBinary::FT_ARCHIVE);
-    mapResult.insert("ZIP", XBinary::FT_ZIP);
-    mapResult.insert("JAR", XBinary::FT_JAR);
-    mapResult.insert("APK", XBinary::FT_APK);
-    mapResult.insert("IPA", XBinary::FT_IPA);
-    mapResult.insert("NPM", XBinary::FT_NPM);
-    mapResult.insert("MACHOFAT", XBinary::FT_MACHOFAT);
-    mapResult.insert("DEB", XBinary::FT_DEB);
-    mapResult.insert("DEX", XBinary::FT_DEX);
-    mapResult.insert("MSDOS", XBinary::FT_MSDOS);
-    mapResult.insert("LE", XBinary::FT_LE);
-    mapResult.insert("LX", XBinary::FT_LX);
-    mapResult.insert("NE", XBinary::FT_NE);
-    mapResult.insert("PE", XBinary::FT_PE);
-    mapResult.insert("ELF", XBinary::FT_ELF);
-    mapResult.insert("MACH", XBinary::FT_MACHO);
-    mapResult.insert("DOS16M", XBinary::FT_DOS16M);
-    mapResult.insert("DOS4G", XBinary::FT_DOS4G);
-    mapResult.insert("Amiga", XBinary::FT_AMIGAHUNK);
-    mapResult.insert("AtariST", XBinary::FT_ATARIST);
-    mapResult.insert("JavaClass", XBinary::FT_JAVACLASS);
-    mapResult.insert("PYC", XBinary::FT_PYC);
-    mapResult.insert("PDF", XBinary::FT_PDF);
-    mapResult.insert("CFBF", XBinary::FT_CFBF);
-    mapResult.insert("Image", XBinary::FT_IMAGE);
-    mapResult.insert("JPEG", XBinary::FT_JPEG);
-    mapResult.insert("PNG", XBinary::FT_PNG);
-    mapResult.insert("RAR", XBinary::FT_RAR);
-    mapResult.insert("ISO9660", XBinary::FT_ISO9660);
+    // The previous snapshot is released here and not by a reload, like the lists were only replaced by the next load
+    QMutexLocker locker(&m_mutexHeldDatabase);
+    m_pHeldDatabase = pDatabase;
 
-    return mapResult;
+    return pDatabase.data();
 }
 
-QList<XScanEngine::METADATA_RECORD> XScanEngine::_parseMetadata(const QString &sData, XBinary::FT fileType)
+QSharedPointer<const XScanEngine::DATABASE_SNAPSHOT> XScanEngine::_getDatabase() const
 {
-    QList<METADATA_RECORD> listResult;
-
-    QStringList listLines = sData.split(QChar('\n'));
-    qint32 nNumberOfLines = listLines.count();
+    QReadLocker locker(&m_lockDatabase);
 
-    for (qint32 i = 0; i < nNumberOfLines; i++) {
-        QString sLine = listLines.at(i).trimmed();
+    return m_pDatabase;
+}
 
-        if (sLine.isEmpty()) {
-            continue;
-        }
+QString XScanEngine::_getSignatureKey(const SIGNATURE_RECORD &record)
+{
+    return QString("%1|%2").arg(record.sFilePath, record.sName);
+}
 
-        METADATA_RECORD record = {};
-        record.fileType = fileType;
+void XScanEngine::_compareSignatures(const QList<SIGNATURE_RECORD> &listOld, const QList<SIGNATURE_RECORD> &listNew, DATABASE_RELOAD_RESULT *pResult)
+{
+    QHash<QString, qint32> mapOld;
+    QSet<QString> stFound;
 
-        qint32 nPos = sLine.indexOf(QChar('#'));
+    qint32 nNumberOfOld = listOld.count();
 
-        if (nPos != -1) {
-            record.sName = sLine.left(nPos).trimmed();
+    for (qint32 i = 0; i < nNumberOfOld; i++) {
+        mapOld.insert(_getSignatureKey(listOld.at(i)), i);
+    }
 
-            QString sTags = sLine.mid(nPos + 1).trimmed();
+    qint32 nNumberOfNew = listNew.count();
 
-            if (!sTags.isEmpty()) {
-                QStringList listTags = sTags.split(QChar(','));
-                qint32 nNumberOfTags = listTags.count();
+    for (qint32 i = 0; i < nNumberOfNew; i++) {
+        const SIGNATURE_RECORD &record = listNew.at(i);
+        QString sKey = _getSignatureKey(record);
+        qint32 nIndex = mapOld.value(sKey, -1);
 
-                for (qint32 j = 0; j < nNumberOfTags; j++) {
-                    QString sTag = listTags.at(j).trimmed();
+        if (nIndex == -1) {
+            pResult->listAdded.append(record.sFilePath);
+        } else {
+            stFound.insert(sKey);
 
-                    if (!sTag.isEmpty()) {
-                        record.listTags.append(sTag);
-                    }
-                }
+            if (listOld.at(nIndex).sText != record.sText) {
+                pResult->listChanged.append(record.sFilePath);
             }
-        } else {
-            record.sName = sLine;
         }
+    }
 
-        if (!record.sName.isEmpty()) {
-            listResult.append(record);
+    for (qint32 i = 0; i < nNumberOfOld; i++) {
+        if (!stFound.contains(_getSignatureKey(listOld.at(i)))) {
+            pResult->listRemoved.append(listOld.at(i).sFilePath);
         }
     }
-
-    return listResult;
 }
 
-void XScanEngine::loadMetadata(const QString &sDatabasePath, XBinary::PDSTRUCT *pPdStruct)
+XScanEngine::DATABASE_RELOAD_RESULT XScanEngine::reloadDatabase(XBinary::PDSTRUCT *pPdStruct)
 {
     XBinary::PDSTRUCT pdStructEmpty = XBinary::createPdStruct();
 
@@ -1471,235 +1592,651 @@ void XScanEngine::loadMetadata(const QString &sDatabasePath, XBinary::PDSTRUCT *
         pPdStruct = &pdStructEmpty;
     }
 
-    QString _sDatabasePath = sDatabasePath;
+    QMutexLocker lockerReload(&m_mutexDatabaseReload);
 
-    if (_sDatabasePath == "") {
-        _sDatabasePath = "$data/db";
+    DATABASE_RELOAD_RESULT result = {};
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT);
+
+    // Built next to the live database; the directory cache only parses the signature files that changed
+    result.bSuccess = _loadDatabaseSnapshot(pDatabase.data(), pPdStruct);
+
+    if (result.bSuccess && XBinary::isPdStructNotCanceled(pPdStruct)) {
+        QSharedPointer<const DATABASE_SNAPSHOT> pOldDatabase = _getDatabase();
+
+        _compareSignatures(pOldDatabase->listSignatures, pDatabase->listSignatures, &result);
+        _setDatabase(pDatabase);
+    } else {
+        result.bSuccess = false;
     }
 
-    _sDatabasePath = XOptions::convertPathName(_sDatabasePath);
+    result.nElapsedTime = timer.elapsed();
 
-    QMap<QString, XBinary::FT> mapFileTypes = _getDatabaseFileTypeMap();
+    return result;
+}
 
-    if (XBinary::isFileExists(_sDatabasePath)) {
-        // Load metadata from db.zip (any "_metadata/<FileType>.txt" record)
-        QFile file;
-        file.setFileName(_sDatabasePath);
+bool XScanEngine::startDatabaseWatcher()
+{
+    stopDatabaseWatcher();
 
-        if (file.open(QIODevice::ReadOnly)) {
-            XZip zip(&file);
+    m_pDatabaseWatcher = new QFileSystemWatcher(this);
+    m_pDatabaseReloadTimer = new QTimer(this);
 
-            if (zip.isValid(pPdStruct)) {
-                QList<XArchive::RECORD> listRecords = zip.getRecords(-1, pPdStruct);
-                qint32 nNumberOfRecords = listRecords.count();
+    // Editors and unpackers touch many files at once, reload after they settle
+    m_pDatabaseReloadTimer->setSingleShot(true);
+    m_pDatabaseReloadTimer->setInterval(500);
 
-                for (qint32 i = 0; (i < nNumberOfRecords) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
-                    XArchive::RECORD _record = listRecords.at(i);
-                    QFileInfo fi(_record.spInfo.sRecordName);
+    connect(m_pDatabaseWatcher, SIGNAL(directoryChanged(QString)), this, SLOT(_databaseChangedSlot(QString)));
+    connect(m_pDatabaseWatcher, SIGNAL(fileChanged(QString)), this, SLOT(_databaseChangedSlot(QString)));
+    connect(m_pDatabaseReloadTimer, SIGNAL(timeout()), this, SLOT(_databaseReloadSlot()));
 
-                    if ((fi.suffix().toLower() == "txt") && (fi.dir().dirName() == "_metadata")) {
-                        XBinary::FT fileType = mapFileTypes.value(fi.completeBaseName(), XBinary::FT_UNKNOWN);
-                        QString sData = zip.decompress(&_record, pPdStruct);
-                        m_listMetadata.append(_parseMetadata(sData, fileType));
-                    }
-                }
-            }
+    _updateDatabaseWatcher();
 
-            file.close();
-        }
-    } else if (XBinary::isDirectoryExists(_sDatabasePath)) {
-        // Load metadata from directory (<db>/_metadata/<FileType>.txt)
-        QString sMetadataPath = _sDatabasePath + QDir::separator() + "_metadata";
+    return (m_pDatabaseWatcher->directories().count() + m_pDatabaseWatcher->files().count()) > 0;
+}
 
-        if (XBinary::isDirectoryExists(sMetadataPath)) {
-            QDir dir(sMetadataPath);
-            QFileInfoList eil = dir.entryInfoList(QStringList() << "*.txt", QDir::Files);
-            qint32 nNumberOfFiles = eil.count();
+void XScanEngine::stopDatabaseWatcher()
+{
+    if (m_pDatabaseReloadTimer) {
+        m_pDatabaseReloadTimer->stop();
+        delete m_pDatabaseReloadTimer;
+        m_pDatabaseReloadTimer = nullptr;
+    }
 
-            for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
-                XBinary::FT fileType = mapFileTypes.value(eil.at(i).completeBaseName(), XBinary::FT_UNKNOWN);
-                QString sData = XBinary::readFile(eil.at(i).absoluteFilePath(), pPdStruct);
-                m_listMetadata.append(_parseMetadata(sData, fileType));
-            }
-        }
+    if (m_pDatabaseWatcher) {
+        delete m_pDatabaseWatcher;
+        m_pDatabaseWatcher = nullptr;
     }
 }
 
-bool XScanEngine::loadDatabase(const QString &sDatabasePath, DT databaseType, bool bUseCache, XBinary::PDSTRUCT *pPdStruct)
+bool XScanEngine::isDatabaseWatcherActive()
 {
-    bool bResult = false;
-
-    QString _sDatabasePath = sDatabasePath;
+    return (m_pDatabaseWatcher != nullptr);
+}
 
-    if (_sDatabasePath == "") {
-        if (databaseType == DT_MAIN) {
-            _sDatabasePath = "$data/db";
-        } else if (databaseType == DT_CUSTOM) {
-            _sDatabasePath = "$data/db_custom";
-        }
+void XScanEngine::_updateDatabaseWatcher()
+{
+    if (m_pDatabaseWatcher == nullptr) {
+        return;
     }
 
-    if (_sDatabasePath != "") {
-#ifdef QT_DEBUG
-        QElapsedTimer *pElapsedTimer = new QElapsedTimer;
-        pElapsedTimer->start();
-#endif
-        _sDatabasePath = XOptions::convertPathName(_sDatabasePath);
+    QStringList listOldPaths = m_pDatabaseWatcher->directories() + m_pDatabaseWatcher->files();
 
-        if (XBinary::isFileExists(_sDatabasePath)) {
-            // Load from zip
-            // TODO load from tar(cache)
-            QFile file;
-            file.setFileName(_sDatabasePath);
+    if (!listOldPaths.isEmpty()) {
+        m_pDatabaseWatcher->removePaths(listOldPaths);
+    }
 
-            if (file.open(QIODevice::ReadOnly)) {
-                XZip zip(&file);
-
-                if (zip.isValid(pPdStruct)) {
-                    QList<XArchive::RECORD> listRecords = zip.getRecords(-1, pPdStruct);  // TODO Check
-
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "", XBinary::FT_UNKNOWN));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "Binary", XBinary::FT_BINARY));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "COM", XBinary::FT_COM));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "Archive", XBinary::FT_ARCHIVE));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "ZIP", XBinary::FT_ZIP));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "JAR", XBinary::FT_JAR));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "APK", XBinary::FT_APK));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "IPA", XBinary::FT_IPA));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "NPM", XBinary::FT_NPM));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "MACHOFAT", XBinary::FT_MACHOFAT));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "DEB", XBinary::FT_DEB));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "DEX", XBinary::FT_DEX));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "MSDOS", XBinary::FT_MSDOS));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "LE", XBinary::FT_LE));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "LX", XBinary::FT_LX));  // TODO Check
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "NE", XBinary::FT_NE));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "PE", XBinary::FT_PE));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "PE/DOTNET", XBinary::FT_CLI_ASSEMBLY));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "ELF", XBinary::FT_ELF));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "MACH", XBinary::FT_MACHO));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "DOS16M", XBinary::FT_DOS16M));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "DOS4G", XBinary::FT_DOS4G));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "Amiga", XBinary::FT_AMIGAHUNK));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "AtariST", XBinary::FT_ATARIST));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "JavaClass", XBinary::FT_JAVACLASS));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "PYC", XBinary::FT_PYC));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "PDF", XBinary::FT_PDF));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "CFBF", XBinary::FT_CFBF));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "Image", XBinary::FT_IMAGE));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "JPEG", XBinary::FT_JPEG));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "PNG", XBinary::FT_PNG));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "RAR", XBinary::FT_RAR));
-                    m_listSignatures.append(_loadDatabaseFromArchive(&zip, &listRecords, databaseType, "ISO9660", XBinary::FT_ISO9660));
+    QStringList listDatabasePaths;
+    listDatabasePaths.append((m_databaseWatch.sMainDatabasePath == "") ? "$data/db" : m_databaseWatch.sMainDatabasePath);
 
-                    bResult = true;
-                }
+    if (m_databaseWatch.bUseCustomDatabase) {
+        listDatabasePaths.append((m_databaseWatch.sCustomDatabasePath == "") ? "$data/db_custom" : m_databaseWatch.sCustomDatabasePath);
+    }
 
-                file.close();
-            }
-        } else if (XBinary::isDirectoryExists(_sDatabasePath)) {
-            // Load from directory with optional cache optimization
-            QString sCachePath;
-            bool bCacheLoaded = false;
-            quint32 nFileCount = 0;
-            quint64 nTotalSize = 0;
-            qint64 nNewestMtime = 0;
+    QStringList listPaths;
+    qint32 nNumberOfDatabasePaths = listDatabasePaths.count();
 
-            sCachePath = _getDatabaseCachePath(_sDatabasePath);
+    for (qint32 i = 0; i < nNumberOfDatabasePaths; i++) {
+        QString sDatabasePath = XOptions::convertPathName(listDatabasePaths.at(i));
 
-            if (bUseCache) {
-                // Fast path: try cache first, only walk directory if cache file exists
-                if (XBinary::isFileExists(sCachePath)) {
-                    _getDatabaseStats(_sDatabasePath, &nFileCount, &nTotalSize, &nNewestMtime);
-                    bCacheLoaded = _loadDatabaseCache(sCachePath, nFileCount, nTotalSize, nNewestMtime, pPdStruct);
-                }
-            } else {
-                // Remove stale cache file when caching is disabled
-                if (XBinary::isFileExists(sCachePath)) {
-                    QFile::remove(sCachePath);
-                }
-            }
+        if (XBinary::isFileExists(sDatabasePath)) {
+            // A replaced archive is a new file, so its directory is watched too
+            listPaths.append(sDatabasePath);
+            listPaths.append(QFileInfo(sDatabasePath).absolutePath());
+        } else if (XBinary::isDirectoryExists(sDatabasePath)) {
+            listPaths.append(sDatabasePath);
+            listPaths.append(sDatabasePath + QDir::separator() + "_metadata");
 
-            if (bCacheLoaded) {
-                // Cache was already sorted when saved, no re-sort needed
-                bResult = true;
-            } else {
-                QList<SIGNATURE_RECORD> listNewRecords;
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath, databaseType, XBinary::FT_UNKNOWN, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "Binary", databaseType, XBinary::FT_BINARY, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "COM", databaseType, XBinary::FT_COM, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "Archive", databaseType, XBinary::FT_ARCHIVE, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "ZIP", databaseType, XBinary::FT_ZIP, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "JAR", databaseType, XBinary::FT_JAR, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "APK", databaseType, XBinary::FT_APK, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "IPA", databaseType, XBinary::FT_IPA, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "NPM", databaseType, XBinary::FT_NPM, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "MACHOFAT", databaseType, XBinary::FT_MACHOFAT, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "DEB", databaseType, XBinary::FT_DEB, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "DEX", databaseType, XBinary::FT_DEX, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "MSDOS", databaseType, XBinary::FT_MSDOS, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "LE", databaseType, XBinary::FT_LE, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "LX", databaseType, XBinary::FT_LX, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "NE", databaseType, XBinary::FT_NE, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "PE", databaseType, XBinary::FT_PE, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "PE/DOTNET", databaseType, XBinary::FT_CLI_ASSEMBLY, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "ELF", databaseType, XBinary::FT_ELF, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "MACH", databaseType, XBinary::FT_MACHO, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "DOS16M", databaseType, XBinary::FT_DOS16M, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "DOS4G", databaseType, XBinary::FT_DOS4G, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "Amiga", databaseType, XBinary::FT_AMIGAHUNK, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "AtariST", databaseType, XBinary::FT_ATARIST, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "JavaClass", databaseType, XBinary::FT_JAVACLASS, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "PYC", databaseType, XBinary::FT_PYC, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "PDF", databaseType, XBinary::FT_PDF, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "CFBF", databaseType, XBinary::FT_CFBF, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "Image", databaseType, XBinary::FT_IMAGE, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "JPEG", databaseType, XBinary::FT_JPEG, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "PNG", databaseType, XBinary::FT_PNG, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "RAR", databaseType, XBinary::FT_RAR, pPdStruct));
-                listNewRecords.append(_loadDatabaseFromPath(_sDatabasePath + QDir::separator() + "ISO9660", databaseType, XBinary::FT_ISO9660, pPdStruct));
-
-                std::sort(listNewRecords.begin(), listNewRecords.end(), sort_signature_prio);
+            QList<DATABASE_FOLDER> listFolders = _getDatabaseFolders();
+            qint32 nNumberOfFolders = listFolders.count();
 
-                if (bUseCache) {
-                    if (nFileCount == 0) {
-                        _getDatabaseStats(_sDatabasePath, &nFileCount, &nTotalSize, &nNewestMtime);
-                    }
-                    _saveDatabaseCache(sCachePath, listNewRecords, nFileCount, nTotalSize, nNewestMtime);
+            for (qint32 j = 0; j < nNumberOfFolders; j++) {
+                if (listFolders.at(j).sName != "") {
+                    listPaths.append(sDatabasePath + QDir::separator() + listFolders.at(j).sName);
                 }
-
-                m_listSignatures.append(listNewRecords);
-                bResult = true;
             }
-        } else {
-            if (databaseType == DT_MAIN) {
-                QString sErrorString = QString("%1: %2").arg(tr("Cannot load database")).arg(_sDatabasePath);
 
-                emit errorMessage(sErrorString);
+            // Directories only report added and removed entries
+            QList<DATABASE_FILE> listFiles = _getDatabaseFiles(sDatabasePath, nullptr);
+            qint32 nNumberOfFiles = listFiles.count();
+
+            for (qint32 j = 0; j < nNumberOfFiles; j++) {
+                listPaths.append(listFiles.at(j).sFilePath);
             }
         }
+    }
 
-        if (!bResult) {
-            std::sort(m_listSignatures.begin(), m_listSignatures.end(), sort_signature_prio);
+    QStringList listExistingPaths;
+    qint32 nNumberOfPaths = listPaths.count();
+
+    for (qint32 i = 0; i < nNumberOfPaths; i++) {
+        if (QFileInfo::exists(listPaths.at(i)) && (!listExistingPaths.contains(listPaths.at(i)))) {
+            listExistingPaths.append(listPaths.at(i));
         }
+    }
 
-#ifdef QT_DEBUG
-        qDebug("DiE_Script::loadDatabase: %lld ms", pElapsedTimer->elapsed());
-#endif
+    if (!listExistingPaths.isEmpty()) {
+        m_pDatabaseWatcher->addPaths(listExistingPaths);
     }
+}
 
-    return bResult;
+void XScanEngine::_databaseChangedSlot(const QString &sPath)
+{
+    Q_UNUSED(sPath)
+
+    if (m_pDatabaseReloadTimer) {
+        m_pDatabaseReloadTimer->start();
+    }
 }
 
-QList<XScanEngine::SIGNATURE_STATE> XScanEngine::getSignatureStates()
+void XScanEngine::_databaseReloadSlot()
 {
-    QList<SIGNATURE_STATE> listResult;
+    DATABASE_RELOAD_RESULT result = reloadDatabase();
 
-    QList<XBinary::FT> listFT;
+    // Rewritten files can drop out of the watcher
+    _updateDatabaseWatcher();
 
-    listFT.append(XBinary::FT_BINARY);
-    listFT.append(XBinary::FT_COM);
-    listFT.append(XBinary::FT_MSDOS);
+    if (result.bSuccess) {
+        emit infoMessage(QString("%1: %2 %3, %4 %5, %6 %7 (%8 ms)")
+                             .arg(tr("Database reloaded"), QString::number(result.listAdded.count()), tr("added"), QString::number(result.listChanged.count()),
+                                  tr("changed"), QString::number(result.listRemoved.count()), tr("removed"), QString::number(result.nElapsedTime)));
+    } else {
+        emit errorMessage(tr("Cannot reload database"));
+    }
+
+    emit databaseReloaded(result);
+}
+
+void XScanEngine::_buildLiteralIndex(DATABASE_SNAPSHOT *pDatabase)
+{
+    pDatabase->literalIndex.clear();
+
+    qint32 nNumberOfSignatures = pDatabase->listSignatures.count();
+
+    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+        pDatabase->literalIndex.addSignature(i, pDatabase->listSignatures.at(i).sText);
+    }
+
+    pDatabase->literalIndex.build();
+
+#ifdef QT_DEBUG
+    qDebug("XScanEngine: literal index: %d of %d signatures", pDatabase->literalIndex.getNumberOfIndexedSignatures(), nNumberOfSignatures);
+#endif
+}
+
+void XScanEngine::_buildSignatureBuckets(DATABASE_SNAPSHOT *pDatabase)
+{
+    pDatabase->mapSignatureBuckets.clear();
+    pDatabase->mapNumberOfSignatures.clear();
+
+    qint32 nNumberOfSignatures = pDatabase->listSignatures.count();
+
+    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+        const SIGNATURE_RECORD &record = pDatabase->listSignatures.at(i);
+
+        pDatabase->mapSignatureBuckets[record.fileType].append(i);
+
+        if (record.sName != "_init") {
+            pDatabase->mapNumberOfSignatures[record.fileType]++;
+        }
+    }
+
+    // First record wins, as the linear search did
+    pDatabase->mapSignatureIndexes.clear();
+    pDatabase->mapSignatureIndexes.reserve(nNumberOfSignatures);
+
+    for (qint32 i = nNumberOfSignatures - 1; i >= 0; i--) {
+        pDatabase->mapSignatureIndexes.insert(pDatabase->listSignatures.at(i).sFilePath, i);
+    }
+}
+
+void XScanEngine::_buildMetadataIndex(DATABASE_SNAPSHOT *pDatabase)
+{
+    pDatabase->mapTagSignatures.clear();
+
+    QHash<QString, qint32> mapMetadataIndexes;
+
+    qint32 nNumberOfMetadata = pDatabase->listMetadata.count();
+
+    // First record wins
+    for (qint32 i = nNumberOfMetadata - 1; i >= 0; i--) {
+        const METADATA_RECORD &metadata = pDatabase->listMetadata.at(i);
+        mapMetadataIndexes.insert(_getMetadataKey(metadata.fileType, metadata.sName), i);
+    }
+
+    qint32 nNumberOfSignatures = pDatabase->listSignatures.count();
+
+    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+        const SIGNATURE_RECORD &record = pDatabase->listSignatures.at(i);
+
+        QStringList listTags;
+        qint32 nIndex = mapMetadataIndexes.value(_getMetadataKey(record.fileType, QFileInfo(record.sFilePath).fileName()), -1);
+
+        if (nIndex != -1) {
+            listTags = pDatabase->listMetadata.at(nIndex).listTags;
+        }
+
+        if (record.listTags != listTags) {
+            pDatabase->listSignatures[i].listTags = listTags;
+        }
+
+        qint32 nNumberOfTags = listTags.count();
+
+        for (qint32 j = 0; j < nNumberOfTags; j++) {
+            pDatabase->mapTagSignatures[listTags.at(j)].append(i);
+        }
+    }
+}
+
+QString XScanEngine::_getMetadataKey(XBinary::FT fileType, const QString &sName)
+{
+    return QString("%1|%2").arg(QString::number(fileType), sName);
+}
+
+bool XScanEngine::_isMetadataFile(const QString &sFileName, XBinary::FT *pFileType)
+{
+    bool bResult = false;
+
+    // "_metadata/<FileType>.txt" at any depth; the cheap test first, it runs for every archive record
+    if (sFileName.contains("_metadata")) {
+        QFileInfo fi(sFileName);
+
+        if ((fi.suffix().toLower() == "txt") && (fi.dir().dirName() == "_metadata")) {
+            *pFileType = _getDatabaseFileTypeMap().value(fi.completeBaseName(), XBinary::FT_UNKNOWN);
+            bResult = true;
+        }
+    }
+
+    return bResult;
+}
+
+QString XScanEngine::_getDatabaseFingerprint(const DATABASE_SNAPSHOT *pDatabase)
+{
+    QCryptographicHash hash(QCryptographicHash::Md5);
+
+    qint32 nNumberOfSignatures = pDatabase->listSignatures.count();
+
+    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+        const SIGNATURE_RECORD &record = pDatabase->listSignatures.at(i);
+
+        hash.addData((const char *)record.sFilePath.constData(), record.sFilePath.size() * (qint32)sizeof(QChar));
+        hash.addData((const char *)record.sText.constData(), record.sText.size() * (qint32)sizeof(QChar));
+        hash.addData(QByteArray::number(record.fileType));
+    }
+
+    return hash.result().toHex();
+}
+
+QString XScanEngine::getDatabaseFingerprint()
+{
+    return _getDatabase()->sFingerprint;
+}
+
+void XScanEngine::initMetadata()
+{
+    QWriteLocker locker(&m_lockDatabase);
+
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT(*m_pDatabase));
+    pDatabase->listMetadata.clear();
+    _buildMetadataIndex(pDatabase.data());
+
+    m_pDatabase = pDatabase;
+}
+
+const QList<XScanEngine::METADATA_RECORD> *XScanEngine::getMetadata()
+{
+    return &(_holdDatabase()->listMetadata);
+}
+
+QList<QString> XScanEngine::getMetadataTags()
+{
+    return _getDatabase()->mapTagSignatures.keys();
+}
+
+QVector<qint32> XScanEngine::getSignatureIndexesByTag(const QString &sTag)
+{
+    return _getDatabase()->mapTagSignatures.value(sTag);
+}
+
+QStringList XScanEngine::getSignatureTags(const QString &sSignatureFilePath)
+{
+    QStringList listResult;
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    qint32 nIndex = pDatabase->mapSignatureIndexes.value(sSignatureFilePath, -1);
+
+    if (nIndex != -1) {
+        listResult = pDatabase->listSignatures.at(nIndex).listTags;
+    }
+
+    return listResult;
+}
+
+QMap<QString, XBinary::FT> XScanEngine::_getDatabaseFileTypeMap()
+{
+    QMap<QString, XBinary::FT> mapResult;
+
+    mapResult.insert("Binary", XBinary::FT_BINARY);
+    mapResult.insert("COM", XBinary::FT_COM);
+    mapResult.insert("Archive", XBinary::FT_ARCHIVE);
+    mapResult.insert("ZIP", XBinary::FT_ZIP);
+    mapResult.insert("JAR", XBinary::FT_JAR);
+    mapResult.insert("APK", XBinary::FT_APK);
+    mapResult.insert("IPA", XBinary::FT_IPA);
+    mapResult.insert("NPM", XBinary::FT_NPM);
+    mapResult.insert("MACHOFAT", XBinary::FT_MACHOFAT);
+    mapResult.insert("DEB", XBinary::FT_DEB);
+    mapResult.insert("DEX", XBinary::FT_DEX);
+    mapResult.insert("MSDOS", XBinary::FT_MSDOS);
+    mapResult.insert("LE", XBinary::FT_LE);
+    mapResult.insert("LX", XBinary::FT_LX);
+    mapResult.insert("NE", XBinary::FT_NE);
+    mapResult.insert("PE", XBinary::FT_PE);
+    mapResult.insert("ELF", XBinary::FT_ELF);
+    mapResult.insert("MACH", XBinary::FT_MACHO);
+    mapResult.insert("DOS16M", XBinary::FT_DOS16M);
+    mapResult.insert("DOS4G", XBinary::FT_DOS4G);
+    mapResult.insert("Amiga", XBinary::FT_AMIGAHUNK);
+    mapResult.insert("AtariST", XBinary::FT_ATARIST);
+    mapResult.insert("JavaClass", XBinary::FT_JAVACLASS);
+    mapResult.insert("PYC", XBinary::FT_PYC);
+    mapResult.insert("PDF", XBinary::FT_PDF);
+    mapResult.insert("CFBF", XBinary::FT_CFBF);
+    mapResult.insert("Image", XBinary::FT_IMAGE);
+    mapResult.insert("JPEG", XBinary::FT_JPEG);
+    mapResult.insert("PNG", XBinary::FT_PNG);
+    mapResult.insert("RAR", XBinary::FT_RAR);
+    mapResult.insert("ISO9660", XBinary::FT_ISO9660);
+
+    return mapResult;
+}
+
+QList<XScanEngine::METADATA_RECORD> XScanEngine::_parseMetadata(const QString &sData, XBinary::FT fileType)
+{
+    QList<METADATA_RECORD> listResult;
+
+    QStringList listLines = sData.split(QChar('\n'));
+    qint32 nNumberOfLines = listLines.count();
+
+    for (qint32 i = 0; i < nNumberOfLines; i++) {
+        QString sLine = listLines.at(i).trimmed();
+
+        if (sLine.isEmpty()) {
+            continue;
+        }
+
+        METADATA_RECORD record = {};
+        record.fileType = fileType;
+
+        qint32 nPos = sLine.indexOf(QChar('#'));
+
+        if (nPos != -1) {
+            record.sName = sLine.left(nPos).trimmed();
+
+            QString sTags = sLine.mid(nPos + 1).trimmed();
+
+            if (!sTags.isEmpty()) {
+                QStringList listTags = sTags.split(QChar(','));
+                qint32 nNumberOfTags = listTags.count();
+
+                for (qint32 j = 0; j < nNumberOfTags; j++) {
+                    QString sTag = listTags.at(j).trimmed();
+
+                    if (!sTag.isEmpty()) {
+                        record.listTags.append(sTag);
+                    }
+                }
+            }
+        } else {
+            record.sName = sLine;
+        }
+
+        if (!record.sName.isEmpty()) {
+            listResult.append(record);
+        }
+    }
+
+    return listResult;
+}
+
+void XScanEngine::loadMetadata(const QString &sDatabasePath, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<METADATA_RECORD> listMetadata;
+
+    _loadMetadata(sDatabasePath, &listMetadata, pPdStruct);
+
+    QWriteLocker locker(&m_lockDatabase);
+
+    QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT(*m_pDatabase));
+    pDatabase->listMetadata.append(listMetadata);
+    _buildMetadataIndex(pDatabase.data());
+
+    m_pDatabase = pDatabase;
+}
+
+void XScanEngine::_loadMetadata(const QString &sDatabasePath, QList<METADATA_RECORD> *pListMetadata, XBinary::PDSTRUCT *pPdStruct)
+{
+    XBinary::PDSTRUCT pdStructEmpty = XBinary::createPdStruct();
+
+    if (pPdStruct == nullptr) {
+        pPdStruct = &pdStructEmpty;
+    }
+
+    QString _sDatabasePath = sDatabasePath;
+
+    if (_sDatabasePath == "") {
+        _sDatabasePath = "$data/db";
+    }
+
+    _sDatabasePath = XOptions::convertPathName(_sDatabasePath);
+
+    if (XBinary::isFileExists(_sDatabasePath)) {
+        // Load metadata from db.zip (any "_metadata/<FileType>.txt" record)
+        QFile file;
+        file.setFileName(_sDatabasePath);
+
+        if (file.open(QIODevice::ReadOnly)) {
+            XZip zip(&file);
+
+            if (zip.isValid(pPdStruct)) {
+                QList<XArchive::RECORD> listRecords = zip.getRecords(-1, pPdStruct);
+                qint32 nNumberOfRecords = listRecords.count();
+
+                for (qint32 i = 0; (i < nNumberOfRecords) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+                    XArchive::RECORD _record = listRecords.at(i);
+                    XBinary::FT fileType = XBinary::FT_UNKNOWN;
+
+                    if (_isMetadataFile(_record.spInfo.sRecordName, &fileType)) {
+                        QString sData = zip.decompress(&_record, pPdStruct);
+                        pListMetadata->append(_parseMetadata(sData, fileType));
+                    }
+                }
+            }
+
+            file.close();
+        }
+    } else if (XBinary::isDirectoryExists(_sDatabasePath)) {
+        // Load metadata from directory (<db>/_metadata/<FileType>.txt)
+        QString sMetadataPath = _sDatabasePath + QDir::separator() + "_metadata";
+
+        if (XBinary::isDirectoryExists(sMetadataPath)) {
+            QMap<QString, XBinary::FT> mapFileTypes = _getDatabaseFileTypeMap();
+
+            QDir dir(sMetadataPath);
+            QFileInfoList eil = dir.entryInfoList(QStringList() << "*.txt", QDir::Files);
+            qint32 nNumberOfFiles = eil.count();
+
+            for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+                XBinary::FT fileType = mapFileTypes.value(eil.at(i).completeBaseName(), XBinary::FT_UNKNOWN);
+                QString sData = XBinary::readFile(eil.at(i).absoluteFilePath(), pPdStruct);
+                pListMetadata->append(_parseMetadata(sData, fileType));
+            }
+        }
+    }
+}
+
+bool XScanEngine::loadDatabase(const QString &sDatabasePath, DT databaseType, bool bUseCache, DATABASE_SNAPSHOT *pDatabase, XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = false;
+
+    // Metadata is read for the main database only, as before it was loaded together with the signatures
+    QList<METADATA_RECORD> *pListMetadata = nullptr;
+
+    if (databaseType == DT_MAIN) {
+        pListMetadata = &(pDatabase->listMetadata);
+    }
+
+    QString _sDatabasePath = sDatabasePath;
+
+    if (_sDatabasePath == "") {
+        if (databaseType == DT_MAIN) {
+            _sDatabasePath = "$data/db";
+        } else if (databaseType == DT_CUSTOM) {
+            _sDatabasePath = "$data/db_custom";
+        }
+    }
+
+    if (_sDatabasePath != "") {
+#ifdef QT_DEBUG
+        QElapsedTimer *pElapsedTimer = new QElapsedTimer;
+        pElapsedTimer->start();
+#endif
+        _sDatabasePath = XOptions::convertPathName(_sDatabasePath);
+
+        if (XBinary::isFileExists(_sDatabasePath)) {
+            // Load from zip with optional cache optimization
+            QFile file;
+            file.setFileName(_sDatabasePath);
+
+            if (file.open(QIODevice::ReadOnly)) {
+                // Keyed on the archive content, so the same db.zip hits the cache wherever it is installed.
+                // The records store their databaseType, so a main and a custom load of one archive need their own caches
+                QCryptographicHash hash(QCryptographicHash::Md5);
+                hash.addData(&file);
+                file.seek(0);
+
+                QString sCachePath = _getDatabaseCachePath(QString("%1:zip:%2:%3").arg(getEngineName(), QString(hash.result().toHex())).arg(databaseType));
+                bool bCacheLoaded = false;
+                quint32 nFileCount = 1;
+                quint64 nTotalSize = file.size();
+                qint64 nNewestMtime = 0;  // Content is already part of the key
+
+                if (bUseCache) {
+                    if (XBinary::isFileExists(sCachePath)) {
+                        bCacheLoaded = _loadDatabaseCache(sCachePath, nFileCount, nTotalSize, nNewestMtime, &(pDatabase->listSignatures),
+                                                          &(pDatabase->listCacheFiles), pPdStruct);
+                    }
+                } else {
+                    // Remove stale cache files when caching is disabled
+                    if (XBinary::isFileExists(sCachePath)) {
+                        QFile::remove(sCachePath);
+                    }
+
+                    if (XBinary::isFileExists(_getDatabaseMetadataCachePath(sCachePath))) {
+                        QFile::remove(_getDatabaseMetadataCachePath(sCachePath));
+                    }
+                }
+
+                if (bCacheLoaded) {
+                    // Cache keeps the archive load order; the metadata has its own cache file, so the archive is not listed
+                    if (pListMetadata && (!_loadDatabaseMetadataCache(_getDatabaseMetadataCachePath(sCachePath), getEngineName(), pListMetadata))) {
+                        QList<METADATA_RECORD> listMetadata;
+
+                        _loadMetadata(_sDatabasePath, &listMetadata, pPdStruct);
+
+                        if (XBinary::isPdStructNotCanceled(pPdStruct)) {
+                            _saveDatabaseMetadataCache(_getDatabaseMetadataCachePath(sCachePath), getEngineName(), listMetadata);
+                        }
+
+                        pListMetadata->append(listMetadata);
+                    }
+
+                    bResult = true;
+                } else {
+                    QList<SIGNATURE_RECORD> listNewRecords;
+                    QList<METADATA_RECORD> listMetadata;
+
+                    if (_loadDatabaseFromArchive(_sDatabasePath, databaseType, 0, &listNewRecords, pListMetadata ? &listMetadata : nullptr, pPdStruct)) {
+                        if (bUseCache && XBinary::isPdStructNotCanceled(pPdStruct)) {
+                            _saveDatabaseCache(sCachePath, listNewRecords, nFileCount, nTotalSize, nNewestMtime);
+
+                            if (pListMetadata) {
+                                _saveDatabaseMetadataCache(_getDatabaseMetadataCachePath(sCachePath), getEngineName(), listMetadata);
+                            }
+                        }
+
+                        if (pListMetadata) {
+                            pListMetadata->append(listMetadata);
+                        }
+
+                        pDatabase->listSignatures.append(listNewRecords);
+                        bResult = true;
+                    }
+                }
+
+                file.close();
+            }
+        } else if (XBinary::isDirectoryExists(_sDatabasePath)) {
+            // Load from directory; the cache is patched per signature file instead of being rebuilt
+            QString sCachePath = _getDatabaseCachePath(QString("%1:%2").arg(_sDatabasePath).arg(databaseType));
+
+            if (!bUseCache) {
+                // Remove stale cache files when caching is disabled
+                if (XBinary::isFileExists(sCachePath)) {
+                    QFile::remove(sCachePath);
+                }
+
+                if (XBinary::isFileExists(_getDatabaseManifestPath(sCachePath))) {
+                    QFile::remove(_getDatabaseManifestPath(sCachePath));
+                }
+            }
+
+            QList<SIGNATURE_RECORD> listNewRecords;
+            QList<QSharedPointer<QFile>> listCacheFiles;
+
+            if (_loadDatabaseFromPathCached(_sDatabasePath, sCachePath, databaseType, bUseCache, &listNewRecords, &listCacheFiles, pPdStruct)) {
+                pDatabase->listSignatures.append(listNewRecords);
+                pDatabase->listCacheFiles.append(listCacheFiles);
+
+                if (pListMetadata) {
+                    _loadMetadata(_sDatabasePath, pListMetadata, pPdStruct);
+                }
+
+                bResult = true;
+            }
+        } else {
+            if (databaseType == DT_MAIN) {
+                QString sErrorString = QString("%1: %2").arg(tr("Cannot load database")).arg(_sDatabasePath);
+
+                emit errorMessage(sErrorString);
+            }
+        }
+
+        if (!bResult) {
+            std::sort(pDatabase->listSignatures.begin(), pDatabase->listSignatures.end(), sort_signature_prio);
+        }
+
+#ifdef QT_DEBUG
+        qDebug("DiE_Script::loadDatabase: %lld ms", pElapsedTimer->elapsed());
+#endif
+    }
+
+    return bResult;
+}
+
+QList<XScanEngine::SIGNATURE_STATE> XScanEngine::getSignatureStates()
+{
+    QList<SIGNATURE_STATE> listResult;
+
+    QList<XBinary::FT> listFT;
+
+    listFT.append(XBinary::FT_BINARY);
+    listFT.append(XBinary::FT_COM);
+    listFT.append(XBinary::FT_MSDOS);
     listFT.append(XBinary::FT_NE);
     listFT.append(XBinary::FT_LE);
     listFT.append(XBinary::FT_LX);
@@ -1728,327 +2265,1425 @@ QList<XScanEngine::SIGNATURE_STATE> XScanEngine::getSignatureStates()
     listFT.append(XBinary::FT_DOS16M);
     listFT.append(XBinary::FT_DOS4G);
 
-    qint32 nNumberOfFileTypes = listFT.count();
+    qint32 nNumberOfFileTypes = listFT.count();
+
+    for (qint32 i = 0; i < nNumberOfFileTypes; i++) {
+        SIGNATURE_STATE state = {};
+        state.fileType = listFT.at(i);
+        state.nNumberOfSignatures = getNumberOfSignatures(state.fileType);
+
+        if (state.nNumberOfSignatures > 0) {
+            listResult.append(state);
+        }
+    }
+
+    return listResult;
+}
+
+qint32 XScanEngine::getNumberOfSignatures(XBinary::FT fileType)
+{
+    qint32 nResult = 0;
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    QMap<XBinary::FT, qint32>::const_iterator iter = pDatabase->mapNumberOfSignatures.constBegin();
+
+    while (iter != pDatabase->mapNumberOfSignatures.constEnd()) {
+        if (XBinary::checkFileType(iter.key(), fileType)) {
+            nResult += iter.value();
+        }
+
+        ++iter;
+    }
+
+    return nResult;
+}
+
+QVector<qint32> XScanEngine::getSignatureIndexes(XBinary::FT fileType)
+{
+    QVector<qint32> listResult;
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    QMap<XBinary::FT, QVector<qint32>>::const_iterator iter = pDatabase->mapSignatureBuckets.constBegin();
+
+    while (iter != pDatabase->mapSignatureBuckets.constEnd()) {
+        if (XBinary::checkFileType(iter.key(), fileType)) {
+            if (listResult.isEmpty()) {
+                // Usually the only bucket: shared, not copied
+                listResult = iter.value();
+            } else {
+                // Buckets are in list order; merging keeps the signature priority
+                QVector<qint32> listMerged;
+                listMerged.reserve(listResult.count() + iter.value().count());
+
+                std::merge(listResult.constBegin(), listResult.constEnd(), iter.value().constBegin(), iter.value().constEnd(), std::back_inserter(listMerged));
+
+                listResult = listMerged;
+            }
+        }
+
+        ++iter;
+    }
+
+    return listResult;
+}
+
+QSharedPointer<const XScanEngine::DATABASE_SNAPSHOT> XScanEngine::getDatabaseSnapshot(const SCAN_OPTIONS *pOptions)
+{
+    if (pOptions && pOptions->pDatabase) {
+        return pOptions->pDatabase;
+    }
+
+    return _getDatabase();
+}
+
+const QList<XScanEngine::SIGNATURE_RECORD> *XScanEngine::getSignatures()
+{
+    return &(_holdDatabase()->listSignatures);
+}
+
+XScanEngine::SIGNATURE_RECORD XScanEngine::getSignatureByFilePath(const QString &sSignatureFilePath)
+{
+    SIGNATURE_RECORD result = {};
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    qint32 nIndex = pDatabase->mapSignatureIndexes.value(sSignatureFilePath, -1);
+
+    if (nIndex != -1) {
+        result = pDatabase->listSignatures.at(nIndex);
+        detachSignatureRecord(&result);
+    }
+
+    return result;
+}
+
+bool XScanEngine::updateSignature(const QString &sSignatureFilePath, const QString &sText)
+{
+    bool bResult = false;
+
+    QWriteLocker locker(&m_lockDatabase);
+
+    qint32 nIndex = m_pDatabase->mapSignatureIndexes.value(sSignatureFilePath, -1);
+
+    if (nIndex != -1) {
+        if (XBinary::writeToFile(sSignatureFilePath, QByteArray().append(sText.toUtf8()))) {
+            // Copy on write: clones and running scans keep the snapshot they hold
+            QSharedPointer<DATABASE_SNAPSHOT> pDatabase(new DATABASE_SNAPSHOT(*m_pDatabase));
+
+            pDatabase->listSignatures[nIndex].sText = sText;
+            pDatabase->listSignatures[nIndex].sInitType = _getSignatureInitType(sText);
+
+            // Nothing is rebuilt: the edited signature always passes the prefilter, stats are recomputed on demand
+            pDatabase->literalIndex.setAlwaysRun(nIndex);
+            pDatabase->sFingerprint = _getDatabaseFingerprint(pDatabase.data());
+
+            m_pDatabase = pDatabase;
+
+            bResult = true;
+        }
+    }
+
+    return bResult;
+}
+
+XScanEngine::STATS XScanEngine::getStats()
+{
+    // The type is extracted when signatures are loaded; this only counts
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    QMutexLocker locker(&m_mutexStats);
+
+    // Every change publishes a new snapshot, so the cached stats belong to one snapshot
+    if (m_pStatsDatabase.toStrongRef() != pDatabase) {
+        m_stats = {};
+
+        qint32 nNumberOfSignatures = pDatabase->listSignatures.count();
+
+        for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+            const QString &sType = pDatabase->listSignatures.at(i).sInitType;
+
+            if (sType != "") {
+                m_stats.mapTypes[sType]++;
+            }
+        }
+
+        m_pStatsDatabase = pDatabase;
+    }
+
+    return m_stats;
+}
+
+QString XScanEngine::_getSignatureInitType(const QString &sText)
+{
+    return XBinary::regExp("init\\(\"(.*?)\",", sText, 1);
+}
+
+bool XScanEngine::isSignaturesPresent(XBinary::FT fileType)
+{
+    return _getDatabase()->mapSignatureBuckets.contains(fileType);
+}
+
+QList<XScanEngine::DATABASE_FOLDER> XScanEngine::_getDatabaseFolders()
+{
+    QList<DATABASE_FOLDER> listResult;
+
+    // Load order; signatures of one folder stay together in this order
+    listResult.append({"", XBinary::FT_UNKNOWN});
+    listResult.append({"Binary", XBinary::FT_BINARY});
+    listResult.append({"COM", XBinary::FT_COM});
+    listResult.append({"Archive", XBinary::FT_ARCHIVE});
+    listResult.append({"ZIP", XBinary::FT_ZIP});
+    listResult.append({"JAR", XBinary::FT_JAR});
+    listResult.append({"APK", XBinary::FT_APK});
+    listResult.append({"IPA", XBinary::FT_IPA});
+    listResult.append({"NPM", XBinary::FT_NPM});
+    listResult.append({"MACHOFAT", XBinary::FT_MACHOFAT});
+    listResult.append({"DEB", XBinary::FT_DEB});
+    listResult.append({"DEX", XBinary::FT_DEX});
+    listResult.append({"MSDOS", XBinary::FT_MSDOS});
+    listResult.append({"LE", XBinary::FT_LE});
+    listResult.append({"LX", XBinary::FT_LX});  // TODO Check
+    listResult.append({"NE", XBinary::FT_NE});
+    listResult.append({"PE", XBinary::FT_PE});
+    listResult.append({"PE/DOTNET", XBinary::FT_CLI_ASSEMBLY});
+    listResult.append({"ELF", XBinary::FT_ELF});
+    listResult.append({"MACH", XBinary::FT_MACHO});
+    listResult.append({"DOS16M", XBinary::FT_DOS16M});
+    listResult.append({"DOS4G", XBinary::FT_DOS4G});
+    listResult.append({"Amiga", XBinary::FT_AMIGAHUNK});
+    listResult.append({"AtariST", XBinary::FT_ATARIST});
+    listResult.append({"JavaClass", XBinary::FT_JAVACLASS});
+    listResult.append({"PYC", XBinary::FT_PYC});
+    listResult.append({"PDF", XBinary::FT_PDF});
+    listResult.append({"CFBF", XBinary::FT_CFBF});
+    listResult.append({"Image", XBinary::FT_IMAGE});
+    listResult.append({"JPEG", XBinary::FT_JPEG});
+    listResult.append({"PNG", XBinary::FT_PNG});
+    listResult.append({"RAR", XBinary::FT_RAR});
+    listResult.append({"ISO9660", XBinary::FT_ISO9660});
+
+    return listResult;
+}
+
+QList<XScanEngine::DATABASE_FILE> XScanEngine::_getDatabaseFiles(const QString &sDatabasePath, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<DATABASE_FILE> listResult;
+
+    QList<DATABASE_FOLDER> listFolders = _getDatabaseFolders();
+    qint32 nNumberOfFolders = listFolders.count();
+
+    // Listing is cheap and isSignatureFileValid may not be reentrant, so only reading and parsing may go to the pool
+    for (qint32 i = 0; (i < nNumberOfFolders) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        QString sFolderPath = sDatabasePath;
+
+        if (listFolders.at(i).sName != "") {
+            sFolderPath += QDir::separator() + listFolders.at(i).sName;
+        }
+
+        QDir dir(sFolderPath);
+
+        QFileInfoList eil = dir.entryInfoList();
+
+        qint32 nNumberOfFiles = eil.count();
+
+        for (qint32 j = 0; j < nNumberOfFiles; j++) {
+            if (isSignatureFileValid(eil.at(j).absoluteFilePath())) {
+                DATABASE_FILE databaseFile = {};
+                databaseFile.sFilePath = eil.at(j).absoluteFilePath();
+                databaseFile.fileType = listFolders.at(i).fileType;
+                databaseFile.nRecordIndex = -1;
+                databaseFile.nSize = eil.at(j).size();
+                databaseFile.nMtime = eil.at(j).lastModified().toMSecsSinceEpoch();
+
+                listResult.append(databaseFile);
+            }
+        }
+    }
+
+    return listResult;
+}
+
+QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::_loadDatabaseFromPath(const QString &sDatabasePath, DT databaseType, qint32 nNumberOfThreads,
+                                                                        XBinary::PDSTRUCT *pPdStruct)
+{
+    return _loadDatabaseFiles("", nullptr, _getDatabaseFiles(sDatabasePath, pPdStruct), databaseType, nNumberOfThreads, nullptr, pPdStruct);
+}
+
+bool XScanEngine::_loadDatabaseFromPathCached(const QString &sDatabasePath, const QString &sCachePath, DT databaseType, bool bUseCache,
+                                              QList<SIGNATURE_RECORD> *pListRecords, QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<DATABASE_FILE> listFiles = _getDatabaseFiles(sDatabasePath, pPdStruct);
+    qint32 nNumberOfFiles = listFiles.count();
+
+    QString sManifestPath = _getDatabaseManifestPath(sCachePath);
+
+    DATABASE_MANIFEST manifest = {};
+    QList<SIGNATURE_RECORD> listCachedRecords;
+    QList<QSharedPointer<QFile>> listCacheFiles;
+
+    bool bCacheLoaded = false;
+
+    if (bUseCache && XBinary::isFileExists(sCachePath) && _loadDatabaseManifest(sManifestPath, getEngineName(), &manifest)) {
+        bCacheLoaded = _loadDatabaseCache(sCachePath, manifest.nFileCount, manifest.nTotalSize, manifest.nNewestMtime, &listCachedRecords, &listCacheFiles, pPdStruct);
+
+        // Every cached record needs its source file, otherwise the cache is rebuilt
+        if (bCacheLoaded && (manifest.listRecordFiles.count() != listCachedRecords.count())) {
+            bCacheLoaded = false;
+            listCachedRecords.clear();
+            listCacheFiles.clear();
+        }
+    }
+
+    QHash<QString, qint32> mapOldFiles;
+
+    if (bCacheLoaded) {
+        qint32 nNumberOfOldFiles = manifest.listFiles.count();
+
+        for (qint32 i = 0; i < nNumberOfOldFiles; i++) {
+            mapOldFiles.insert(manifest.listFiles.at(i).sFilePath, i);
+        }
+    }
+
+    // Size and mtime decide first; the content hash only settles files that were touched but may be unchanged
+    QList<DATABASE_FILE_STATE> listStates;
+    QList<DATABASE_FILE> listChangedFiles;
+    QList<qint32> listChangedIndexes;
+    QSet<QString> stChangedFiles;
+    bool bManifestChanged = (!bCacheLoaded) || (nNumberOfFiles != manifest.listFiles.count());
+
+    for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        const DATABASE_FILE &databaseFile = listFiles.at(i);
+
+        DATABASE_FILE_STATE state = {};
+        state.sFilePath = databaseFile.sFilePath;
+        state.nSize = databaseFile.nSize;
+        state.nMtime = databaseFile.nMtime;
+
+        bool bChanged = true;
+        qint32 nOldIndex = mapOldFiles.value(databaseFile.sFilePath, -1);
+
+        if (nOldIndex != -1) {
+            const DATABASE_FILE_STATE &oldState = manifest.listFiles.at(nOldIndex);
+
+            if ((oldState.nSize == state.nSize) && (oldState.nMtime == state.nMtime)) {
+                state.baHash = oldState.baHash;
+                bChanged = false;
+            } else {
+                state.baHash = _getDatabaseFileHash(state.sFilePath);
+                bChanged = (oldState.baHash.isEmpty()) || (oldState.baHash != state.baHash);
+                bManifestChanged = true;
+            }
+        }
+
+        if (bChanged) {
+            listChangedFiles.append(databaseFile);
+            listChangedIndexes.append(i);
+            stChangedFiles.insert(databaseFile.sFilePath);
+            bManifestChanged = true;
+        }
+
+        listStates.append(state);
+    }
+
+    if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+        return false;
+    }
+
+    if (!bManifestChanged) {
+        // Nothing changed: the mapped records are used as they are
+        pListRecords->append(listCachedRecords);
+        pListCacheFiles->append(listCacheFiles);
+
+        return true;
+    }
+
+    // Records are grouped by the index of the file they were parsed from; their sFilePath may name another file
+    QVector<QList<SIGNATURE_RECORD>> listFileRecords(nNumberOfFiles);
+
+    if (listChangedFiles.count() != nNumberOfFiles) {
+        QHash<QString, qint32> mapNewFiles;
+
+        for (qint32 i = 0; i < nNumberOfFiles; i++) {
+            mapNewFiles.insert(listFiles.at(i).sFilePath, i);
+        }
+
+        // Kept records must outlive the mapping of the cache that is about to be rewritten
+        qint32 nNumberOfCachedRecords = listCachedRecords.count();
+
+        for (qint32 i = 0; i < nNumberOfCachedRecords; i++) {
+            const QString &sOldFilePath = manifest.listFiles.at(manifest.listRecordFiles.at(i)).sFilePath;
+            qint32 nNewIndex = mapNewFiles.value(sOldFilePath, -1);
+
+            if ((nNewIndex != -1) && (!stChangedFiles.contains(sOldFilePath))) {
+                SIGNATURE_RECORD record = listCachedRecords.at(i);
+                detachSignatureRecord(&record);
+                listFileRecords[nNewIndex].append(record);
+            }
+        }
+    }
+
+    listCachedRecords.clear();
+    listCacheFiles.clear();
+
+    QList<qint32> listParsedFiles;
+    QList<SIGNATURE_RECORD> listParsedRecords = _loadDatabaseFiles("", nullptr, listChangedFiles, databaseType, 0, &listParsedFiles, pPdStruct);
+
+    if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+        return false;
+    }
+
+    qint32 nNumberOfParsedRecords = listParsedRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfParsedRecords; i++) {
+        listFileRecords[listChangedIndexes.at(listParsedFiles.at(i))].append(listParsedRecords.at(i));
+    }
+
+    // Same sequence as a fresh load: listing order, records of one file in parse order
+    QList<SIGNATURE_RECORD> listRecords;
+    QList<qint32> listRecordFiles;
+
+    for (qint32 i = 0; i < nNumberOfFiles; i++) {
+        qint32 nNumberOfFileRecords = listFileRecords.at(i).count();
+
+        for (qint32 j = 0; j < nNumberOfFileRecords; j++) {
+            listRecords.append(listFileRecords.at(i).at(j));
+            listRecordFiles.append(i);
+        }
+    }
+
+    // The sort is stable, so records that compare equal keep that order and the result matches a full rebuild.
+    // It runs over indexes so that each record keeps its source file for the manifest
+    qint32 nNumberOfRecords = listRecords.count();
+    QVector<qint32> listOrder(nNumberOfRecords);
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        listOrder[i] = i;
+    }
+
+    std::stable_sort(listOrder.begin(), listOrder.end(),
+                     [&listRecords](qint32 nIndex1, qint32 nIndex2) { return sort_signature_prio(listRecords.at(nIndex1), listRecords.at(nIndex2)); });
+
+    QList<SIGNATURE_RECORD> listNewRecords;
+    QList<qint32> listNewRecordFiles;
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        listNewRecords.append(listRecords.at(listOrder.at(i)));
+        listNewRecordFiles.append(listRecordFiles.at(listOrder.at(i)));
+    }
+
+    if (bUseCache) {
+        DATABASE_MANIFEST newManifest = {};
+        newManifest.listFiles = listStates;
+        newManifest.listRecordFiles = listNewRecordFiles;
+
+        for (qint32 i = 0; i < nNumberOfFiles; i++) {
+            newManifest.nFileCount++;
+            newManifest.nTotalSize += listStates.at(i).nSize;
+            newManifest.nNewestMtime = qMax(newManifest.nNewestMtime, listStates.at(i).nMtime);
+        }
+
+        _saveDatabaseCache(sCachePath, listNewRecords, newManifest.nFileCount, newManifest.nTotalSize, newManifest.nNewestMtime);
+        _saveDatabaseManifest(sManifestPath, getEngineName(), newManifest);
+
+#ifdef QT_DEBUG
+        qDebug("XScanEngine: cache patched: %d of %d signature files parsed", listChangedFiles.count(), nNumberOfFiles);
+#endif
+    }
+
+    pListRecords->append(listNewRecords);
+
+    return true;
+}
+
+QString XScanEngine::_getDatabaseManifestPath(const QString &sCachePath)
+{
+    return sCachePath + ".files";
+}
+
+QString XScanEngine::_getDatabaseMetadataCachePath(const QString &sCachePath)
+{
+    return sCachePath + ".metadata";
+}
+
+bool XScanEngine::_loadDatabaseMetadataCache(const QString &sFileName, const QString &sEngineName, QList<METADATA_RECORD> *pListMetadata)
+{
+    QFile file(sFileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 nMagic = 0;
+    quint32 nVersion = 0;
+    QString sCachedEngineName;
+
+    stream >> nMagic >> nVersion;
+
+    if ((nMagic != 0x4449454D) || (nVersion != 1)) {
+        return false;
+    }
+
+    stream >> sCachedEngineName;
+
+    if (sCachedEngineName != sEngineName) {
+        return false;
+    }
+
+    QList<METADATA_RECORD> listMetadata;
+    quint32 nNumberOfRecords = 0;
+
+    stream >> nNumberOfRecords;
+
+    for (quint32 i = 0; (i < nNumberOfRecords) && (stream.status() == QDataStream::Ok); i++) {
+        METADATA_RECORD record = {};
+        qint32 nFileType = 0;
+
+        stream >> nFileType >> record.sName >> record.listTags;
+        record.fileType = (XBinary::FT)nFileType;
+
+        listMetadata.append(record);
+    }
+
+    file.close();
+
+    bool bResult = (stream.status() == QDataStream::Ok);
+
+    if (bResult) {
+        pListMetadata->append(listMetadata);
+    }
+
+    return bResult;
+}
+
+void XScanEngine::_saveDatabaseMetadataCache(const QString &sFileName, const QString &sEngineName, const QList<METADATA_RECORD> &listMetadata)
+{
+    QSaveFile file(sFileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << (quint32)0x4449454D;  // Magic "DIEM"
+    stream << (quint32)1;           // Version
+    stream << sEngineName;
+    stream << (quint32)listMetadata.count();
+
+    qint32 nNumberOfRecords = listMetadata.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const METADATA_RECORD &record = listMetadata.at(i);
+
+        stream << (qint32)record.fileType << record.sName << record.listTags;
+    }
+
+    file.commit();
+}
+
+QByteArray XScanEngine::_getDatabaseFileHash(const QString &sFileName)
+{
+    QByteArray baResult;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QCryptographicHash hash(QCryptographicHash::Md5);
+        hash.addData(&file);
+        baResult = hash.result();
+
+        file.close();
+    }
+
+    return baResult;
+}
+
+bool XScanEngine::_loadDatabaseManifest(const QString &sFileName, const QString &sEngineName, DATABASE_MANIFEST *pManifest)
+{
+    QFile file(sFileName);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    quint32 nMagic = 0;
+    quint32 nVersion = 0;
+    QString sCachedEngineName;
+
+    stream >> nMagic >> nVersion;
+
+    if ((nMagic != 0x44494546) || (nVersion != 2)) {
+        return false;
+    }
+
+    stream >> sCachedEngineName;
+
+    if (sCachedEngineName != sEngineName) {
+        return false;
+    }
+
+    quint32 nNumberOfFiles = 0;
+
+    stream >> pManifest->nFileCount >> pManifest->nTotalSize >> pManifest->nNewestMtime >> nNumberOfFiles;
+
+    for (quint32 i = 0; (i < nNumberOfFiles) && (stream.status() == QDataStream::Ok); i++) {
+        DATABASE_FILE_STATE state = {};
+
+        stream >> state.sFilePath >> state.nSize >> state.nMtime >> state.baHash;
+
+        pManifest->listFiles.append(state);
+    }
+
+    quint32 nNumberOfRecords = 0;
+
+    stream >> nNumberOfRecords;
+
+    for (quint32 i = 0; (i < nNumberOfRecords) && (stream.status() == QDataStream::Ok); i++) {
+        qint32 nFileIndex = -1;
+
+        stream >> nFileIndex;
+
+        if ((nFileIndex < 0) || (nFileIndex >= pManifest->listFiles.count())) {
+            return false;
+        }
+
+        pManifest->listRecordFiles.append(nFileIndex);
+    }
+
+    file.close();
+
+    return (stream.status() == QDataStream::Ok);
+}
+
+void XScanEngine::_saveDatabaseManifest(const QString &sFileName, const QString &sEngineName, const DATABASE_MANIFEST &manifest)
+{
+    // Renamed into place on commit(), an interrupted write leaves the previous manifest
+    QSaveFile file(sFileName);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
+
+    QDataStream stream(&file);
+    stream.setVersion(QDataStream::Qt_5_0);
+
+    stream << (quint32)0x44494546;  // Magic "DIEF"
+    stream << (quint32)2;           // Version
+    stream << sEngineName;
+    stream << manifest.nFileCount << manifest.nTotalSize << manifest.nNewestMtime;
+    stream << (quint32)manifest.listFiles.count();
+
+    qint32 nNumberOfFiles = manifest.listFiles.count();
+
+    for (qint32 i = 0; i < nNumberOfFiles; i++) {
+        const DATABASE_FILE_STATE &state = manifest.listFiles.at(i);
+
+        stream << state.sFilePath << state.nSize << state.nMtime << state.baHash;
+    }
+
+    stream << (quint32)manifest.listRecordFiles.count();
+
+    qint32 nNumberOfRecords = manifest.listRecordFiles.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        stream << (qint32)manifest.listRecordFiles.at(i);
+    }
+
+    file.commit();
+}
+
+bool XScanEngine::_loadDatabaseFromArchive(const QString &sFileName, DT databaseType, qint32 nNumberOfThreads, QList<SIGNATURE_RECORD> *pListRecords,
+                                           QList<METADATA_RECORD> *pListMetadata, XBinary::PDSTRUCT *pPdStruct)
+{
+    bool bResult = false;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        XZip zip(&file);
+
+        if (zip.isValid(pPdStruct)) {
+            QList<XArchive::RECORD> listRecords = zip.getRecords(-1, pPdStruct);  // TODO Check
+
+            QList<DATABASE_FOLDER> listFolders = _getDatabaseFolders();
+            qint32 nNumberOfFolders = listFolders.count();
+
+            QMap<QString, qint32> mapFolderIndexes;
+
+            for (qint32 i = 0; i < nNumberOfFolders; i++) {
+                mapFolderIndexes.insert(listFolders.at(i).sName, i);
+            }
+
+            // One pass over the records. A record belongs to the folder named by its first path section and needs a non-empty second one;
+            // nested folders such as "PE/DOTNET" therefore stay with their top-level folder
+            QVector<QList<DATABASE_FILE>> listBuckets(nNumberOfFolders);
+
+            qint32 nNumberOfRecords = listRecords.count();
+
+            for (qint32 i = 0; i < nNumberOfRecords; i++) {
+                const QString &sRecordName = listRecords.at(i).spInfo.sRecordName;
+
+                qint32 nFolderIndex = -1;
+                qint32 nSlash = sRecordName.indexOf(QChar('/'));
+
+                if (nSlash == -1) {
+                    nFolderIndex = mapFolderIndexes.value("", -1);
+                } else {
+                    qint32 nNextSlash = sRecordName.indexOf(QChar('/'), nSlash + 1);
+                    qint32 nSecondSize = (nNextSlash == -1) ? (sRecordName.size() - nSlash - 1) : (nNextSlash - nSlash - 1);
+
+                    if (nSecondSize > 0) {
+                        nFolderIndex = mapFolderIndexes.value(sRecordName.left(nSlash), -1);
+                    }
+                }
+
+                XBinary::FT metadataFileType = XBinary::FT_UNKNOWN;
+
+                if (nFolderIndex != -1) {
+                    DATABASE_FILE databaseFile = {};
+                    databaseFile.sFilePath = sRecordName;
+                    databaseFile.fileType = listFolders.at(nFolderIndex).fileType;
+                    databaseFile.nRecordIndex = i;
+
+                    listBuckets[nFolderIndex].append(databaseFile);
+                } else if (pListMetadata && _isMetadataFile(sRecordName, &metadataFileType)) {
+                    XArchive::RECORD _record = listRecords.at(i);
+                    pListMetadata->append(_parseMetadata(zip.decompress(&_record, pPdStruct), metadataFileType));
+                }
+            }
+
+            QList<DATABASE_FILE> listFiles;
+
+            for (qint32 i = 0; i < nNumberOfFolders; i++) {
+                listFiles.append(listBuckets.at(i));
+            }
+
+            pListRecords->append(_loadDatabaseFiles(sFileName, &listRecords, listFiles, databaseType, nNumberOfThreads, nullptr, pPdStruct));
+
+            bResult = true;
+        }
+
+        file.close();
+    }
+
+    return bResult;
+}
+
+QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::_loadDatabaseFiles(const QString &sArchiveFileName, QList<XArchive::RECORD> *pListArchiveRecords,
+                                                                     const QList<DATABASE_FILE> &listFiles, DT databaseType, qint32 nNumberOfThreads,
+                                                                     QList<qint32> *pListFileIndexes, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<SIGNATURE_RECORD> listResult;
+
+    qint32 nNumberOfFiles = listFiles.count();
+
+    if (nNumberOfThreads <= 0) {
+        nNumberOfThreads = QThread::idealThreadCount();
+    }
+
+    // Archive records are parsed here; files go through the virtual getSignaturesFromData, which runs on the pool only if the engine allows it
+    if ((pListArchiveRecords == nullptr) && (!isDatabaseLoadReentrant())) {
+        nNumberOfThreads = 1;
+    }
+
+    if (nNumberOfThreads <= 1) {
+        // Sequential load on the calling thread
+        _loadDatabaseFilesChunk(sArchiveFileName, pListArchiveRecords, listFiles, databaseType, 0, nNumberOfFiles, &listResult, pListFileIndexes, pPdStruct);
+    } else {
+        // Contiguous chunks; each archive worker opens its own handle, a shared XZip would serialize on one QIODevice
+        qint32 nChunkSize = qMax(1, nNumberOfFiles / (nNumberOfThreads * 4));
+        qint32 nNumberOfChunks = (nNumberOfFiles + nChunkSize - 1) / nChunkSize;
+
+        QVector<QList<SIGNATURE_RECORD>> listChunkResults(nNumberOfChunks);
+        QVector<QList<qint32>> listChunkFileIndexes(nNumberOfChunks);
+
+        QThreadPool threadPool;
+        threadPool.setMaxThreadCount(nNumberOfThreads);
+
+        for (qint32 i = 0; i < nNumberOfChunks; i++) {
+            qint32 nStart = i * nChunkSize;
+            qint32 nEnd = qMin(nStart + nChunkSize, nNumberOfFiles);
+            QList<SIGNATURE_RECORD> *pChunkResult = &(listChunkResults[i]);
+            QList<qint32> *pChunkFileIndexes = &(listChunkFileIndexes[i]);
+
+            QtConcurrent::run(&threadPool, [this, sArchiveFileName, pListArchiveRecords, &listFiles, databaseType, nStart, nEnd, pChunkResult, pChunkFileIndexes,
+                                            pPdStruct]() {
+                _loadDatabaseFilesChunk(sArchiveFileName, pListArchiveRecords, listFiles, databaseType, nStart, nEnd, pChunkResult, pChunkFileIndexes, pPdStruct);
+            });
+        }
 
-    for (qint32 i = 0; i < nNumberOfFileTypes; i++) {
-        SIGNATURE_STATE state = {};
-        state.fileType = listFT.at(i);
-        state.nNumberOfSignatures = getNumberOfSignatures(state.fileType);
+        threadPool.waitForDone();
 
-        if (state.nNumberOfSignatures > 0) {
-            listResult.append(state);
+        // Chunks are merged in list order, so the result matches a sequential load
+        for (qint32 i = 0; i < nNumberOfChunks; i++) {
+            listResult.append(listChunkResults.at(i));
+
+            if (pListFileIndexes) {
+                pListFileIndexes->append(listChunkFileIndexes.at(i));
+            }
         }
     }
 
     return listResult;
 }
 
-qint32 XScanEngine::getNumberOfSignatures(XBinary::FT fileType)
+void XScanEngine::_loadDatabaseFilesChunk(const QString &sArchiveFileName, QList<XArchive::RECORD> *pListArchiveRecords, const QList<DATABASE_FILE> &listFiles,
+                                          DT databaseType, qint32 nStart, qint32 nEnd, QList<SIGNATURE_RECORD> *pListRecords, QList<qint32> *pListFileIndexes,
+                                          XBinary::PDSTRUCT *pPdStruct)
 {
-    qint32 nResult = 0;
+    XBinary::PDSTRUCT pdStruct = XBinary::createPdStruct();
+
+    if (pListArchiveRecords) {
+        QFile file;
+        file.setFileName(sArchiveFileName);
 
-    qint32 nNumberOfSignatures = m_listSignatures.count();
+        if (file.open(QIODevice::ReadOnly)) {
+            XZip zip(&file);
+
+            for (qint32 i = nStart; (i < nEnd) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+                const DATABASE_FILE &databaseFile = listFiles.at(i);
+                XArchive::RECORD _record = pListArchiveRecords->at(databaseFile.nRecordIndex);
+
+                SIGNATURE_RECORD record = {};
+
+                record.fileType = databaseFile.fileType;
+                record.sName = QFileInfo(databaseFile.sFilePath).fileName();
+                record.sText = zip.decompress(&_record, nullptr);
+                record.sFilePath = databaseFile.sFilePath;
+                record.databaseType = databaseType;
+                record.bReadOnly = true;
+                record.sInitType = _getSignatureInitType(record.sText);
+                record.nPrio = getSignaturePrio(record.sName);
+
+                pListRecords->append(record);
+
+                if (pListFileIndexes) {
+                    pListFileIndexes->append(i);
+                }
+            }
 
-    for (qint32 i = 0; (i < nNumberOfSignatures); i++) {
-        if ((m_listSignatures.at(i).sName != "_init") && (XBinary::checkFileType(m_listSignatures.at(i).fileType, fileType))) {
-            nResult++;
+            file.close();
         }
-    }
+    } else {
+        for (qint32 i = nStart; (i < nEnd) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+            const DATABASE_FILE &databaseFile = listFiles.at(i);
 
-    return nResult;
-}
+            QString sData = XBinary::readFile(databaseFile.sFilePath, &pdStruct);
+            QList<SIGNATURE_RECORD> listRecords = getSignaturesFromData(sData, databaseFile.sFilePath, databaseFile.fileType, &pdStruct);
 
-QList<XScanEngine::SIGNATURE_RECORD> *XScanEngine::getSignatures()
-{
-    return &m_listSignatures;
+            qint32 nNumberOfRecords = listRecords.count();
+
+            for (qint32 j = 0; j < nNumberOfRecords; j++) {
+                SIGNATURE_RECORD record = listRecords.at(j);
+                record.databaseType = databaseType;
+                record.sInitType = _getSignatureInitType(record.sText);
+                record.nPrio = getSignaturePrio(record.sName);
+                pListRecords->append(record);
+
+                if (pListFileIndexes) {
+                    pListFileIndexes->append(i);
+                }
+            }
+        }
+    }
 }
 
-XScanEngine::SIGNATURE_RECORD XScanEngine::getSignatureByFilePath(const QString &sSignatureFilePath)
+QList<XScanEngine::BENCHMARK_RECORD> XScanEngine::benchmarkDatabaseLoad(const QString &sDatabasePath, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct)
 {
-    SIGNATURE_RECORD result = {};
+    QList<BENCHMARK_RECORD> listResult;
 
-    qint32 nNumberOfSignatures = m_listSignatures.count();
+    QString _sDatabasePath = sDatabasePath;
 
-    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
-        if (m_listSignatures.at(i).sFilePath == sSignatureFilePath) {
-            result = m_listSignatures.at(i);
+    if (_sDatabasePath == "") {
+        _sDatabasePath = "$data/db";
+    }
 
-            break;
+    _sDatabasePath = XOptions::convertPathName(_sDatabasePath);
+
+    bool bArchive = XBinary::isFileExists(_sDatabasePath);
+
+    // Cache bypassed: the sequential load on this thread, then the whole pool. A directory needs isDatabaseLoadReentrant() for the pool
+    qint32 nNumberOfRuns = (bArchive || isDatabaseLoadReentrant()) ? 2 : 1;
+
+    for (qint32 j = 0; j < nNumberOfRuns; j++) {
+        qint32 nNumberOfThreads = (j == 0) ? 1 : QThread::idealThreadCount();
+
+        BENCHMARK_RECORD record = {};
+        record.sName = QString("%1 load, %2 thread(s)").arg(bArchive ? "Archive" : "Directory", QString::number(nNumberOfThreads));
+        record.nIterations = nIterations;
+        record.nMinNs = -1;
+
+        for (qint32 i = 0; (i < nIterations) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+            QElapsedTimer timer;
+            timer.start();
+
+            QList<SIGNATURE_RECORD> listRecords;
+
+            if (bArchive) {
+                _loadDatabaseFromArchive(_sDatabasePath, DT_MAIN, nNumberOfThreads, &listRecords, nullptr, pPdStruct);
+            } else {
+                listRecords = _loadDatabaseFromPath(_sDatabasePath, DT_MAIN, nNumberOfThreads, pPdStruct);
+                std::stable_sort(listRecords.begin(), listRecords.end(), sort_signature_prio);
+            }
+
+            qint64 nElapsed = timer.nsecsElapsed();
+
+            record.nTotalNs += nElapsed;
+            record.nMinNs = (record.nMinNs == -1) ? nElapsed : qMin(record.nMinNs, nElapsed);
+            record.nMaxNs = qMax(record.nMaxNs, nElapsed);
         }
+
+        listResult.append(record);
     }
 
-    return result;
+    return listResult;
 }
 
-bool XScanEngine::updateSignature(const QString &sSignatureFilePath, const QString &sText)
+QString XScanEngine::_getDatabaseCachePath(const QString &sDatabasePath)
+{
+    QString sCacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QDir::separator() + "db_cache";
+    QDir dir(sCacheDir);
+
+    if (!dir.exists()) {
+        dir.mkpath(sCacheDir);
+    }
+
+    QByteArray baHash = QCryptographicHash::hash(sDatabasePath.toUtf8(), QCryptographicHash::Md5);
+    QString sHashName = baHash.toHex() + ".cache";
+
+    return sCacheDir + QDir::separator() + sHashName;
+}
+
+bool XScanEngine::_loadDatabaseCache(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, QList<SIGNATURE_RECORD> *pListRecords,
+                                     QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct)
 {
     bool bResult = false;
 
-    qint32 nNumberOfSignatures = m_listSignatures.count();
+    quint32 nMagic = 0;
+    quint32 nVersion = 0;
+
+    QFile file(sCachePath);
 
-    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
-        if (m_listSignatures.at(i).sFilePath == sSignatureFilePath) {
-            if (XBinary::writeToFile(sSignatureFilePath, QByteArray().append(sText.toUtf8()))) {
-                m_listSignatures[i].sText = sText;
-                bResult = true;
-            }
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+        stream >> nMagic >> nVersion;
+        file.close();
+    }
 
-            break;
+    if ((nMagic == 0x44494543) && (nVersion == 5)) {
+        // v5 is still read so an existing cache is used once more; the next rebuild writes v7
+        QList<SIGNATURE_RECORD> listRecords;
+
+        bResult = _loadDatabaseCacheStream(sCachePath, nFileCount, nTotalSize, nNewestMtime, &listRecords, pPdStruct);
+
+        if (bResult) {
+            pListRecords->append(listRecords);
         }
+    } else {
+        bResult = _loadDatabaseCacheMapped(sCachePath, nFileCount, nTotalSize, nNewestMtime, pListRecords, pListCacheFiles, pPdStruct);
     }
 
     return bResult;
 }
 
-XScanEngine::STATS XScanEngine::getStats()
+bool XScanEngine::_loadDatabaseCacheStream(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime,
+                                           QList<SIGNATURE_RECORD> *pListRecords, XBinary::PDSTRUCT *pPdStruct)
 {
-    STATS result = {};
+    QFile file(sCachePath);
+
+    if (!file.open(QIODevice::ReadOnly)) {
+        return false;
+    }
+
+    // Read entire file into memory for faster deserialization
+    QByteArray baData = file.readAll();
+    file.close();
 
-    qint32 nNumberOfSignatures = m_listSignatures.count();
+    QDataStream stream(baData);
+    stream.setVersion(QDataStream::Qt_5_0);
 
-    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
-        QString sText = m_listSignatures.at(i).sText;
+    quint32 nMagic = 0;
+    quint32 nVersion = 0;
+    quint32 nCachedFileCount = 0;
+    quint64 nCachedTotalSize = 0;
+    qint64 nCachedNewestMtime = 0;
 
-        QString sType = XBinary::regExp("init\\(\"(.*?)\",", sText, 1);
+    QString sCachedEngineName;
+    stream >> nMagic >> nVersion;
 
-        if (sType != "") {
-            result.mapTypes.insert(sType, result.mapTypes.value(sType, 0) + 1);
-        }
+    if (nMagic != 0x44494543 || nVersion != 5) {
+        return false;
     }
 
-    return result;
+    stream >> sCachedEngineName >> nCachedFileCount >> nCachedTotalSize >> nCachedNewestMtime;
+
+    if (sCachedEngineName != getEngineName()) {
+        return false;
+    }
+
+    if (nCachedFileCount != nFileCount || nCachedTotalSize != nTotalSize || nCachedNewestMtime != nNewestMtime) {
+        return false;
+    }
+
+    quint32 nRecordCount = 0;
+    stream >> nRecordCount;
+
+    pListRecords->reserve(pListRecords->size() + nRecordCount);
+
+    for (quint32 i = 0; (i < nRecordCount) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        SIGNATURE_RECORD record = {};
+        qint32 nFileType = 0;
+        qint32 nDatabaseType = 0;
+
+        quint8 nIsEP = 0;
+        stream >> nFileType;
+        stream >> record.sName;
+        stream >> record.sFilePath;
+        stream >> nDatabaseType;
+        stream >> record.sText;
+        stream >> record.sType;
+        stream >> record.sVersion;
+        stream >> record.sInfo;
+        stream >> nIsEP;
+        stream >> record.nLine;
+
+        record.fileType = (XBinary::FT)nFileType;
+        record.databaseType = (DT)nDatabaseType;
+        record.bIsEP = (nIsEP != 0);
+        record.bReadOnly = false;
+        record.sInitType = _getSignatureInitType(record.sText);  // Not in v5
+        record.nPrio = getSignaturePrio(record.sName);
+
+        pListRecords->append(record);
+    }
+
+    if (stream.status() != QDataStream::Ok) {
+        return false;
+    }
+
+#ifdef QT_DEBUG
+    qDebug("XScanEngine: loaded from cache: %s (%u records)", sCachePath.toUtf8().data(), nRecordCount);
+#endif
+
+    return true;
 }
 
-bool XScanEngine::isSignaturesPresent(XBinary::FT fileType)
+bool XScanEngine::_loadDatabaseCacheMapped(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime,
+                                           QList<SIGNATURE_RECORD> *pListRecords, QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct)
 {
-    bool bResult = false;
+    QSharedPointer<QFile> pFile(new QFile(sCachePath));
 
-    qint32 nNumberOfSignatures = m_listSignatures.count();
+    if (!pFile->open(QIODevice::ReadOnly)) {
+        return false;
+    }
 
-    for (qint32 i = 0; i < nNumberOfSignatures; i++) {
-        if (m_listSignatures.at(i).fileType == fileType) {
-            bResult = true;
+    qint64 nSize = pFile->size();
+
+    if (nSize < (qint64)sizeof(DBCACHE_HEADER)) {
+        return false;
+    }
+
+    // The file is used in place: all offsets are relative to its start, strings are UTF-16 and are not copied
+    const char *pData = (const char *)pFile->map(0, nSize);
+
+    if (!pData) {
+        return false;
+    }
+
+    const DBCACHE_HEADER *pHeader = (const DBCACHE_HEADER *)pData;
+
+    if ((pHeader->nMagic != DBCACHE_MAGIC_MAPPED) || (pHeader->nVersion != 7)) {
+        return false;
+    }
+
+    if ((pHeader->nFileCount != nFileCount) || (pHeader->nTotalSize != nTotalSize) || (pHeader->nNewestMtime != nNewestMtime)) {
+        return false;
+    }
+
+    if (((quint64)pHeader->nRecordsOffset + (quint64)pHeader->nRecordCount * sizeof(DBCACHE_RECORD)) > (quint64)nSize) {
+        return false;
+    }
+
+    if ((!isDatabaseCacheStringValid(pHeader->engineName, nSize)) || (getDatabaseCacheString(pData, pHeader->engineName) != getEngineName())) {
+        return false;
+    }
+
+    const DBCACHE_RECORD *pRecords = (const DBCACHE_RECORD *)(pData + pHeader->nRecordsOffset);
+
+    QList<SIGNATURE_RECORD> listRecords;
+    listRecords.reserve(pHeader->nRecordCount);
+
+    bool bValid = true;
+
+    for (quint32 i = 0; (i < pHeader->nRecordCount) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+        const DBCACHE_RECORD *pRecord = &(pRecords[i]);
 
+        if (!(isDatabaseCacheStringValid(pRecord->sName, nSize) && isDatabaseCacheStringValid(pRecord->sFilePath, nSize) &&
+              isDatabaseCacheStringValid(pRecord->sText, nSize) && isDatabaseCacheStringValid(pRecord->sType, nSize) &&
+              isDatabaseCacheStringValid(pRecord->sVersion, nSize) && isDatabaseCacheStringValid(pRecord->sInfo, nSize) &&
+              isDatabaseCacheStringValid(pRecord->sInitType, nSize))) {
+            bValid = false;
             break;
         }
+
+        SIGNATURE_RECORD record = {};
+        record.fileType = (XBinary::FT)pRecord->nFileType;
+        record.databaseType = (DT)pRecord->nDatabaseType;
+        record.nLine = pRecord->nLine;
+        record.sName = getDatabaseCacheString(pData, pRecord->sName);
+        record.sFilePath = getDatabaseCacheString(pData, pRecord->sFilePath);
+        record.sText = getDatabaseCacheString(pData, pRecord->sText);
+        record.sType = getDatabaseCacheString(pData, pRecord->sType);
+        record.sVersion = getDatabaseCacheString(pData, pRecord->sVersion);
+        record.sInfo = getDatabaseCacheString(pData, pRecord->sInfo);
+        record.sInitType = getDatabaseCacheString(pData, pRecord->sInitType);
+        record.nPrio = getSignaturePrio(record.sName);
+        record.bIsEP = (pRecord->nFlags & DBCACHE_FLAG_EP);
+        record.bReadOnly = false;
+
+        listRecords.append(record);
     }
 
-    return bResult;
+    if ((!bValid) || (!XBinary::isPdStructNotCanceled(pPdStruct))) {
+        return false;
+    }
+
+    pListRecords->append(listRecords);
+    pListCacheFiles->append(pFile);
+
+#ifdef QT_DEBUG
+    qDebug("XScanEngine: mapped cache: %s (%u records)", sCachePath.toUtf8().data(), pHeader->nRecordCount);
+#endif
+
+    return true;
 }
 
-QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::_loadDatabaseFromPath(const QString &sDatabasePath, DT databaseType, XBinary::FT fileType, XBinary::PDSTRUCT *pPdStruct)
+void XScanEngine::_saveDatabaseCache(const QString &sCachePath, const QList<SIGNATURE_RECORD> &listRecords, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime,
+                                     quint32 nVersion)
 {
-    QList<SIGNATURE_RECORD> listResult;
+    // Renamed into place on commit(), a cache mapped by the current database keeps its old content
+    QSaveFile file(sCachePath);
+
+    if (!file.open(QIODevice::WriteOnly)) {
+        return;
+    }
 
-    QDir dir(sDatabasePath);
+    quint32 nRecordCount = (quint32)listRecords.count();
 
-    QFileInfoList eil = dir.entryInfoList();
+    if (nVersion == 5) {
+        QDataStream stream(&file);
+        stream.setVersion(QDataStream::Qt_5_0);
+
+        stream << (quint32)0x44494543;  // Magic "DIEC"
+        stream << (quint32)5;           // Version
+        stream << getEngineName();
+        stream << nFileCount;
+        stream << nTotalSize;
+        stream << nNewestMtime;
+
+        stream << nRecordCount;
+
+        for (qint32 i = 0; i < (qint32)nRecordCount; i++) {
+            const SIGNATURE_RECORD &record = listRecords.at(i);
+            stream << (qint32)record.fileType;
+            stream << record.sName;
+            stream << record.sFilePath;
+            stream << (qint32)record.databaseType;
+            stream << record.sText;
+            stream << record.sType;
+            stream << record.sVersion;
+            stream << record.sInfo;
+            stream << (quint8)(record.bIsEP ? 1 : 0);
+            stream << record.nLine;
+        }
+    } else {
+        // Header, fixed-size record table, then one UTF-16 string pool
+        DBCACHE_HEADER header = {};
+        header.nMagic = DBCACHE_MAGIC_MAPPED;
+        header.nVersion = 7;
+        header.nFileCount = nFileCount;
+        header.nRecordCount = nRecordCount;
+        header.nTotalSize = nTotalSize;
+        header.nNewestMtime = nNewestMtime;
+        header.nRecordsOffset = sizeof(DBCACHE_HEADER);
+        header.nStringsOffset = header.nRecordsOffset + nRecordCount * sizeof(DBCACHE_RECORD);
+
+        QByteArray baStrings;
+        QVector<DBCACHE_RECORD> listCacheRecords(nRecordCount);
+
+        header.engineName = addDatabaseCacheString(&baStrings, header.nStringsOffset, getEngineName());
+
+        for (qint32 i = 0; i < (qint32)nRecordCount; i++) {
+            const SIGNATURE_RECORD &record = listRecords.at(i);
+            DBCACHE_RECORD cacheRecord = {};
+
+            cacheRecord.nFileType = (qint32)record.fileType;
+            cacheRecord.nDatabaseType = (qint32)record.databaseType;
+            cacheRecord.nLine = record.nLine;
+            cacheRecord.nFlags = record.bIsEP ? DBCACHE_FLAG_EP : 0;
+            cacheRecord.sName = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sName);
+            cacheRecord.sFilePath = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sFilePath);
+            cacheRecord.sText = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sText);
+            cacheRecord.sType = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sType);
+            cacheRecord.sVersion = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sVersion);
+            cacheRecord.sInfo = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sInfo);
+            cacheRecord.sInitType = addDatabaseCacheString(&baStrings, header.nStringsOffset, record.sInitType);
+
+            listCacheRecords[i] = cacheRecord;
+        }
 
-    qint32 nNumberOfFiles = eil.count();
+        header.nStringsSize = baStrings.size();
 
-    for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
-        if (isSignatureFileValid(eil.at(i).absoluteFilePath())) {
-            QString sData = XBinary::readFile(eil.at(i).absoluteFilePath(), pPdStruct);
-            QList<SIGNATURE_RECORD> listRecords = getSignaturesFromData(sData, eil.at(i).absoluteFilePath(), fileType, pPdStruct);
+        file.write((const char *)&header, sizeof(DBCACHE_HEADER));
+        file.write((const char *)listCacheRecords.constData(), nRecordCount * sizeof(DBCACHE_RECORD));
+        file.write(baStrings);
+    }
 
-            for (qint32 j = 0; j < listRecords.count(); j++) {
-                SIGNATURE_RECORD record = listRecords.at(j);
-                record.databaseType = databaseType;
-                listResult.append(record);
+    file.commit();
+
+#ifdef QT_DEBUG
+    qDebug("XScanEngine: saved cache: %s (%u records, %lld bytes)", sCachePath.toUtf8().data(), nRecordCount, QFileInfo(sCachePath).size());
+#endif
+}
+
+QList<XScanEngine::BENCHMARK_RECORD> XScanEngine::benchmarkDatabaseCache(qint32 nIterations, XBinary::PDSTRUCT *pPdStruct)
+{
+    QList<BENCHMARK_RECORD> listResult;
+
+    QString sStreamPath = QDir::tempPath() + QDir::separator() + QString("%1_benchmark_v5.cache").arg(getEngineName());
+    QString sMappedPath = QDir::tempPath() + QDir::separator() + QString("%1_benchmark_v7.cache").arg(getEngineName());
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = _getDatabase();
+
+    _saveDatabaseCache(sStreamPath, pDatabase->listSignatures, 0, 0, 0, 5);
+    _saveDatabaseCache(sMappedPath, pDatabase->listSignatures, 0, 0, 0, 7);
+
+    // Load only, then load and touch every signature text as a scan would
+    for (qint32 j = 0; j < 4; j++) {
+        bool bMapped = (j % 2);
+        bool bTouchText = (j >= 2);
+
+        BENCHMARK_RECORD record = {};
+        record.sName = QString("%1%2").arg(bMapped ? "v7 mapped" : "v5 stream", bTouchText ? " + text" : "");
+        record.nIterations = nIterations;
+        record.nMinNs = -1;
+
+        for (qint32 i = 0; (i < nIterations) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+            QList<SIGNATURE_RECORD> listRecords;
+            QList<QSharedPointer<QFile>> listCacheFiles;
+
+            QElapsedTimer timer;
+            timer.start();
+
+            if (bMapped) {
+                _loadDatabaseCacheMapped(sMappedPath, 0, 0, 0, &listRecords, &listCacheFiles, pPdStruct);
+            } else {
+                _loadDatabaseCacheStream(sStreamPath, 0, 0, 0, &listRecords, pPdStruct);
+            }
+
+            if (bTouchText) {
+                quint32 nHash = 0;
+                qint32 nNumberOfRecords = listRecords.count();
+
+                for (qint32 k = 0; k < nNumberOfRecords; k++) {
+                    nHash ^= qHash(listRecords.at(k).sText);
+                }
+
+                Q_UNUSED(nHash)
             }
+
+            qint64 nElapsed = timer.nsecsElapsed();
+
+            record.nTotalNs += nElapsed;
+            record.nMinNs = (record.nMinNs == -1) ? nElapsed : qMin(record.nMinNs, nElapsed);
+            record.nMaxNs = qMax(record.nMaxNs, nElapsed);
         }
+
+        listResult.append(record);
     }
 
+    QFile::remove(sStreamPath);
+    QFile::remove(sMappedPath);
+
     return listResult;
 }
 
-QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::_loadDatabaseFromArchive(XArchive *pArchive, QList<XArchive::RECORD> *pListRecords, DT databaseType,
-                                                                           const QString &sPrefix, XBinary::FT fileType)
+QList<XScanEngine::BENCHMARK_RECORD> XScanEngine::benchmarkPEScript(const QList<QString> &listFileNames, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct)
 {
-    QList<SIGNATURE_RECORD> listResult;
+    QList<BENCHMARK_RECORD> listResult;
 
-    qint32 nNumberOfRecords = pListRecords->count();
+    Binary_Script::OPTIONS options = createScriptOptions(nullptr);
 
-    for (qint32 i = 0; i < nNumberOfRecords; i++) {
-        XArchive::RECORD _record = pListRecords->at(i);
+    // Headers and sections only, as most PE signatures; then every member, as the eager constructor did
+    for (qint32 j = 0; j < 2; j++) {
+        bool bLoadAll = (j == 1);
+
+        BENCHMARK_RECORD record = {};
+        record.sName = bLoadAll ? "PE_Script all members" : "PE_Script headers + sections";
+        record.nMinNs = -1;
+
+        qint32 nNumberOfFiles = listFileNames.count();
+
+        for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+            QFile file;
+            file.setFileName(listFileNames.at(i));
+
+            if (file.open(QIODevice::ReadOnly)) {
+                XPE pe(&file);
+
+                if (pe.isValid(pPdStruct)) {
+                    for (qint32 k = 0; (k < nIterations) && XBinary::isPdStructNotCanceled(pPdStruct); k++) {
+                        QElapsedTimer timer;
+                        timer.start();
+
+                        PE_Script peScript(&pe, XBinary::FILEPART_HEADER, options, pPdStruct);
+
+                        if (bLoadAll) {
+                            peScript.loadAll();
+                        } else {
+                            peScript.getNumberOfSections();
+                            peScript.isSectionNamePresent(".text");
+                            peScript.getEntryPointSection();
+                        }
 
-        if (((sPrefix == "") && (!_record.spInfo.sRecordName.contains("/"))) ||
-            ((_record.spInfo.sRecordName.contains("/")) && (_record.spInfo.sRecordName.section("/", 0, 0) == sPrefix) &&
-             (_record.spInfo.sRecordName.section("/", 1, 1) != ""))) {
-            QFileInfo fi(_record.spInfo.sRecordName);
+                        qint64 nElapsed = timer.nsecsElapsed();
 
-            SIGNATURE_RECORD record = {};
+                        record.nIterations++;
+                        record.nTotalNs += nElapsed;
+                        record.nMinNs = (record.nMinNs == -1) ? nElapsed : qMin(record.nMinNs, nElapsed);
+                        record.nMaxNs = qMax(record.nMaxNs, nElapsed);
+                    }
+                }
 
-            record.fileType = fileType;
-            record.sName = fi.fileName();
-            record.sText = pArchive->decompress(&_record, nullptr);
-            record.sFilePath = _record.spInfo.sRecordName;
-            record.databaseType = databaseType;
-            record.bReadOnly = true;
+                file.close();
+            }
+        }
 
-            listResult.append(record);
+        if (record.nMinNs == -1) {
+            record.nMinNs = 0;
         }
+
+        listResult.append(record);
     }
 
     return listResult;
 }
 
-QString XScanEngine::_getDatabaseCachePath(const QString &sDatabasePath)
+QList<XScanEngine::BENCHMARK_RECORD> XScanEngine::benchmarkParseCache(const QList<QString> &listFileNames, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct)
 {
-    QString sCacheDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + QDir::separator() + "db_cache";
-    QDir dir(sCacheDir);
-
-    if (!dir.exists()) {
-        dir.mkpath(sCacheDir);
-    }
+    QList<BENCHMARK_RECORD> listResult;
 
-    QByteArray baHash = QCryptographicHash::hash(sDatabasePath.toUtf8(), QCryptographicHash::Md5);
-    QString sHashName = baHash.toHex() + ".cache";
+    // Each pass reads the format info as _processDetect does and then builds the script of the pass
+    for (qint32 j = 0; j < 2; j++) {
+        bool bParseCache = (j == 1);
 
-    return sCacheDir + QDir::separator() + sHashName;
-}
+        BENCHMARK_RECORD record = {};
+        record.sName = bParseCache ? "All types passes with parse cache" : "All types passes without parse cache";
+        record.nMinNs = -1;
 
-void XScanEngine::_getDatabaseStats(const QString &sDatabasePath, quint32 *pnFileCount, quint64 *pnTotalSize, qint64 *pnNewestMtime)
-{
-    // TODO rewrite
-    // Load from database then show
-    *pnFileCount = 0;
-    *pnTotalSize = 0;
-    *pnNewestMtime = 0;
+        qint32 nNumberOfFiles = listFileNames.count();
 
-    QDirIterator it(sDatabasePath, QDir::Files, QDirIterator::Subdirectories);
+        for (qint32 i = 0; (i < nNumberOfFiles) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+            QFile file;
+            file.setFileName(listFileNames.at(i));
 
-    while (it.hasNext()) {
-        it.next();
-        QFileInfo fi = it.fileInfo();
-        (*pnFileCount)++;
-        (*pnTotalSize) += fi.size();
-        qint64 nMtime = fi.lastModified().toMSecsSinceEpoch();
-        if (nMtime > *pnNewestMtime) {
-            *pnNewestMtime = nMtime;
-        }
-    }
-}
+            if (file.open(QIODevice::ReadOnly)) {
+                XPE pe(&file);
 
-bool XScanEngine::_loadDatabaseCache(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, XBinary::PDSTRUCT *pPdStruct)
-{
-    QFile file(sCachePath);
+                if (pe.isValid(pPdStruct)) {
+                    QList<XBinary::FT> listFileTypes;
+                    listFileTypes.append(pe.getFileType());
 
-    if (!file.open(QIODevice::ReadOnly)) {
-        return false;
-    }
+                    if (XPE::isNETPresent(&file)) {
+                        // The CLI assembly pass, over the same PE
+                        listFileTypes.append(pe.getFileType());
+                    }
 
-    // Read entire file into memory for faster deserialization
-    QByteArray baData = file.readAll();
-    file.close();
+                    listFileTypes.append(XBinary::FT_MSDOS);
+                    listFileTypes.append(XBinary::FT_BINARY);
 
-    QDataStream stream(baData);
-    stream.setVersion(QDataStream::Qt_5_0);
+                    qint32 nNumberOfFileTypes = listFileTypes.count();
 
-    quint32 nMagic = 0;
-    quint32 nVersion = 0;
-    quint32 nCachedFileCount = 0;
-    quint64 nCachedTotalSize = 0;
-    qint64 nCachedNewestMtime = 0;
+                    for (qint32 k = 0; (k < nIterations) && XBinary::isPdStructNotCanceled(pPdStruct); k++) {
+                        QElapsedTimer timer;
+                        timer.start();
 
-    QString sCachedEngineName;
-    stream >> nMagic >> nVersion;
+                        XScanParseCache parseCache;
 
-    if (nMagic != 0x44494543 || nVersion != 5) {
-        return false;
-    }
+                        Binary_Script::OPTIONS options = createScriptOptions(nullptr);
 
-    stream >> sCachedEngineName >> nCachedFileCount >> nCachedTotalSize >> nCachedNewestMtime;
+                        if (bParseCache) {
+                            options.pParseCache = &parseCache;
+                        }
 
-    if (sCachedEngineName != getEngineName()) {
-        return false;
-    }
+                        for (qint32 l = 0; l < nNumberOfFileTypes; l++) {
+                            XBinary *pBinary = XFormats::createClass(listFileTypes.at(l), &file, false, -1);
 
-    if (nCachedFileCount != nFileCount || nCachedTotalSize != nTotalSize || nCachedNewestMtime != nNewestMtime) {
-        return false;
-    }
+                            if (bParseCache) {
+                                parseCache.getFileFormatInfo(pBinary, pPdStruct);
+                            } else {
+                                pBinary->getFileFormatInfo(pPdStruct);
+                            }
 
-    quint32 nRecordCount = 0;
-    stream >> nRecordCount;
+                            Binary_Script binaryScript(pBinary, XBinary::FILEPART_HEADER, options, pPdStruct);
 
-    m_listSignatures.reserve(m_listSignatures.size() + nRecordCount);
+                            delete pBinary;
+                        }
 
-    for (quint32 i = 0; (i < nRecordCount) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
-        SIGNATURE_RECORD record = {};
-        qint32 nFileType = 0;
-        qint32 nDatabaseType = 0;
+                        qint64 nElapsed = timer.nsecsElapsed();
 
-        quint8 nIsEP = 0;
-        stream >> nFileType;
-        stream >> record.sName;
-        stream >> record.sFilePath;
-        stream >> nDatabaseType;
-        stream >> record.sText;
-        stream >> record.sType;
-        stream >> record.sVersion;
-        stream >> record.sInfo;
-        stream >> nIsEP;
-        stream >> record.nLine;
+                        record.nIterations++;
+                        record.nTotalNs += nElapsed;
+                        record.nMinNs = (record.nMinNs == -1) ? nElapsed : qMin(record.nMinNs, nElapsed);
+                        record.nMaxNs = qMax(record.nMaxNs, nElapsed);
+                    }
+                }
 
-        record.fileType = (XBinary::FT)nFileType;
-        record.databaseType = (DT)nDatabaseType;
-        record.bIsEP = (nIsEP != 0);
-        record.bReadOnly = false;
+                file.close();
+            }
+        }
 
-        m_listSignatures.append(record);
-    }
+        if (record.nMinNs == -1) {
+            record.nMinNs = 0;
+        }
 
-    if (stream.status() != QDataStream::Ok) {
-        return false;
+        listResult.append(record);
     }
 
-#ifdef QT_DEBUG
-    qDebug("XScanEngine: loaded from cache: %s (%u records)", sCachePath.toUtf8().data(), nRecordCount);
-#endif
-
-    return true;
+    return listResult;
 }
 
-void XScanEngine::_saveDatabaseCache(const QString &sCachePath, const QList<SIGNATURE_RECORD> &listRecords, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime)
+QString XScanEngine::benchmarkToString(const QList<BENCHMARK_RECORD> &listRecords)
 {
-    QFile file(sCachePath);
+    QString sResult;
 
-    if (!file.open(QIODevice::WriteOnly)) {
-        return;
-    }
+    qint32 nNumberOfRecords = listRecords.count();
 
-    QDataStream stream(&file);
-    stream.setVersion(QDataStream::Qt_5_0);
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const BENCHMARK_RECORD &record = listRecords.at(i);
 
-    stream << (quint32)0x44494543;  // Magic "DIEC"
-    stream << (quint32)5;           // Version
-    stream << getEngineName();
-    stream << nFileCount;
-    stream << nTotalSize;
-    stream << nNewestMtime;
+        qint64 nAverageNs = record.nIterations ? (record.nTotalNs / record.nIterations) : 0;
 
-    quint32 nRecordCount = (quint32)listRecords.count();
-    stream << nRecordCount;
-
-    for (qint32 i = 0; i < (qint32)nRecordCount; i++) {
-        const SIGNATURE_RECORD &record = listRecords.at(i);
-        stream << (qint32)record.fileType;
-        stream << record.sName;
-        stream << record.sFilePath;
-        stream << (qint32)record.databaseType;
-        stream << record.sText;
-        stream << record.sType;
-        stream << record.sVersion;
-        stream << record.sInfo;
-        stream << (quint8)(record.bIsEP ? 1 : 0);
-        stream << record.nLine;
+        sResult += QString("%1: %2 iterations, avg %3 us, min %4 us, max %5 us\n")
+                       .arg(record.sName)
+                       .arg(record.nIterations)
+                       .arg(nAverageNs / 1000)
+                       .arg(record.nMinNs / 1000)
+                       .arg(record.nMaxNs / 1000);
     }
 
-    file.close();
-
-#ifdef QT_DEBUG
-    qDebug("XScanEngine: saved cache: %s (%u records, %lld bytes)", sCachePath.toUtf8().data(), nRecordCount, QFileInfo(sCachePath).size());
-#endif
+    return sResult;
 }
 
 void XScanEngine::_processDetect(SCANID *pScanID, SCAN_RESULT *pScanResult, QIODevice *pDevice, const SCANID &parentId, XBinary::FT fileType, SCAN_OPTIONS *pOptions,
@@ -2058,7 +3693,13 @@ void XScanEngine::_processDetect(SCANID *pScanID, SCAN_RESULT *pScanResult, QIOD
     const XScanEngine::SCANID resultId = createResultId(pDevice, parentId, fileType);
 
             XBinary *pBinary = XFormats::createClass(fileType, pDevice, false, -1);
-    XBinary::FILEFORMATINFO ffi = pBinary->getFileFormatInfo(pPdStruct);
+    XBinary::FILEFORMATINFO ffi = {};
+
+    if (pOptions->pParseCache) {
+        ffi = pOptions->pParseCache->getFileFormatInfo(pBinary, pPdStruct);
+    } else {
+        ffi = pBinary->getFileFormatInfo(pPdStruct);
+    }
 
     if (ffi.fileType != XBinary::FT_BINARY) {
         XScanEngine::SCANSTRUCT scanStruct = {};
@@ -2773,6 +4414,10 @@ Binary_Script::OPTIONS XScanEngine::createScriptOptions(const SCAN_OPTIONS *pSca
         options.bIsOverlayScan = pScanOptions->bIsOverlayScan;
         options.bIsVerbose = pScanOptions->bIsVerbose;
         options.bIsProfiling = pScanOptions->bLogProfiling;
+        options.pProfiler = pScanOptions->pProfiler;
+        options.pParseCache = pScanOptions->pParseCache;
+        options.pWatchdog = pScanOptions->pWatchdog;
+        options.nSignatureTimeout = pScanOptions->nSignatureTimeout;
         options.sScanID = pScanOptions->sScanID;
     }
 
@@ -2838,17 +4483,377 @@ XScanEngine::SCAN_RESULT XScanEngine::scanSubdevice(QIODevice *pDevice, qint64 n
     if (XBinary::isOffsetAndSizeValid(pDevice, nOffset, nSize)) {
         SubDevice sd(pDevice, nOffset, nSize);
 
-        if (sd.open(QIODevice::ReadOnly)) {
-            result = scanDevice(&sd, pOptions, pPdStruct);
+        if (sd.open(QIODevice::ReadOnly)) {
+            result = scanDevice(&sd, pOptions, pPdStruct);
+
+            sd.close();
+        }
+    }
+
+    return result;
+}
+
+void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, bool bInit, XBinary::PDSTRUCT *pPdStruct)
+{
+    if (bInit && (pScanOptions->pWatchdog == nullptr) && ((pScanOptions->nFileTimeout > 0) || (pScanOptions->nSignatureTimeout > 0))) {
+        _scanProcessBudget(pDevice, pScanResult, parentId, pScanOptions, pPdStruct);
+
+        return;
+    }
+
+    if (pScanOptions->pDatabase.isNull()) {
+        // Each scan sees one database from start to end; a reload meanwhile publishes a new snapshot and does not wait
+        SCAN_OPTIONS _options = *pScanOptions;
+        _options.pDatabase = _getDatabase();
+
+        scanProcess(pDevice, pScanResult, parentId, &_options, bInit, pPdStruct);
+
+        return;
+    }
+
+    // Collections copy files and write catalogs, so they always run the full pipeline
+    if (pScanOptions->pResultCache && (!pScanOptions->bCollection)) {
+        QElapsedTimer scanTimer;
+        scanTimer.start();
+
+        QString sKey = _getResultCacheKey(pDevice, pScanOptions);
+        qint64 nBase = _getResultCacheBase(pDevice, pPdStruct);
+
+        XScanResultCache::RECORD record = {};
+
+        if (pScanOptions->pResultCache->find(sKey, &record)) {
+            _rebaseResultCacheRecords(&(record.listRecords), nBase);
+
+            // Fresh ids for every reuse; records without a parent in the cached tree hang off the current parent
+            QMap<QString, QString> mapUuids;
+
+            qint32 nNumberOfRecords = record.listRecords.count();
+
+            for (qint32 i = 0; i < nNumberOfRecords; i++) {
+                const QString &sUuid = record.listRecords.at(i).id.sUuid;
+
+                if (!mapUuids.contains(sUuid)) {
+                    mapUuids.insert(sUuid, XBinary::generateUUID());
+                }
+            }
+
+            for (qint32 i = 0; i < nNumberOfRecords; i++) {
+                SCANSTRUCT scanStruct = record.listRecords.at(i);
+
+                if (mapUuids.contains(scanStruct.parentId.sUuid)) {
+                    scanStruct.parentId.sUuid = mapUuids.value(scanStruct.parentId.sUuid);
+                } else {
+                    scanStruct.parentId = parentId;
+                    scanStruct.id.filePart = parentId.filePart;
+                }
+
+                scanStruct.id.sUuid = mapUuids.value(scanStruct.id.sUuid);
+
+                pScanResult->listRecords.append(scanStruct);
+            }
+
+            pScanResult->listErrors.append(record.listErrors);
+            pScanResult->listDebugRecords.append(record.listDebugRecords);
+            pScanResult->ftInit = record.ftInit;
+
+            if (bInit) {
+                pScanResult->sFileName = XBinary::getDeviceFileName(pDevice);
+                pScanResult->nSize = pDevice->size();
+                pScanResult->nScanTime = scanTimer.elapsed();
+            }
+        } else {
+            qint32 nRecordsStart = pScanResult->listRecords.count();
+            qint32 nErrorsStart = pScanResult->listErrors.count();
+            qint32 nDebugRecordsStart = pScanResult->listDebugRecords.count();
+            bool bIsSignatureTimeout = pScanResult->bIsSignatureTimeout;
+
+            pScanResult->bIsSignatureTimeout = false;
+
+            _scanProcess(pDevice, pScanResult, parentId, pScanOptions, bInit, pPdStruct);
+
+            bool bIsPartial = pScanResult->bIsSignatureTimeout;
+
+            pScanResult->bIsSignatureTimeout = bIsSignatureTimeout || bIsPartial;
+
+            // A cancelled or timed out scan is incomplete and must not be reused
+            if (XBinary::isPdStructNotCanceled(pPdStruct) && (!bIsPartial)) {
+                record.ftInit = pScanResult->ftInit;
+                record.listRecords = pScanResult->listRecords.mid(nRecordsStart);
+                record.listErrors = pScanResult->listErrors.mid(nErrorsStart);
+                record.listDebugRecords = pScanResult->listDebugRecords.mid(nDebugRecordsStart);
+
+                _rebaseResultCacheRecords(&(record.listRecords), -nBase);
+
+                pScanOptions->pResultCache->insert(sKey, record);
+            }
+        }
+    } else {
+        _scanProcess(pDevice, pScanResult, parentId, pScanOptions, bInit, pPdStruct);
+    }
+}
+
+void XScanEngine::_scanProcessBudget(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pPdStruct)
+{
+    XScanWatchdog watchdog;
+
+    SCAN_OPTIONS _options = *pScanOptions;
+    _options.pWatchdog = &watchdog;
+
+    // A budget stops this file only, a cancel of the caller is forwarded
+    XBinary::PDSTRUCT pdStruct = XBinary::createPdStruct();
+    qint32 nWatch = watchdog.add(&pdStruct, pPdStruct, pScanOptions->nFileTimeout);
+
+    scanProcess(pDevice, pScanResult, parentId, &_options, true, &pdStruct);
+
+    if (watchdog.remove(nWatch)) {
+        pScanResult->bIsTimeout = true;
+
+        ERROR_RECORD errorRecord = {};
+        errorRecord.sScript = tr("Timeout");
+        errorRecord.sErrorString = QString("%1 ms").arg(pScanOptions->nFileTimeout);
+
+        pScanResult->listErrors.append(errorRecord);
+    }
+}
+
+QString XScanEngine::getScanOptionsFingerprint(const SCAN_OPTIONS *pScanOptions)
+{
+    QString sResult;
+
+    sResult += QString("%1%2%3%4%5%6%7%8%9")
+                   .arg(pScanOptions->bIsDeepScan)
+                   .arg(pScanOptions->bIsHeuristicScan)
+                   .arg(pScanOptions->bIsFirstWrapperScan)
+                   .arg(pScanOptions->bIsAggressiveScan)
+                   .arg(pScanOptions->bIsRecursiveScan)
+                   .arg(pScanOptions->bIsOverlayScan)
+                   .arg(pScanOptions->bIsResourcesScan)
+                   .arg(pScanOptions->bIsArchivesScan)
+                   .arg(pScanOptions->bIsVerbose);
+    sResult += QString("%1%2%3%4%5")
+                   .arg(pScanOptions->bIsAllTypesScan)
+                   .arg(pScanOptions->bShowInternalDetects)
+                   .arg(pScanOptions->bUseLiteralPrefilter)
+                   .arg(pScanOptions->bVerifyLiteralPrefilter)
+                   .arg(pScanOptions->bIsImage);
+    sResult += QString("|%1|%2|%3").arg(pScanOptions->fileType).arg(pScanOptions->initFilePart).arg(pScanOptions->sScanID);
+    sResult += QString("|%1|%2").arg(pScanOptions->sSignatureName, pScanOptions->sDetectFunction);
+    sResult += QString("|%1|%2").arg(pScanOptions->nFileTimeout).arg(pScanOptions->nSignatureTimeout);
+
+    return sResult;
+}
+
+QString XScanEngine::_getResultCacheKey(QIODevice *pDevice, SCAN_OPTIONS *pScanOptions)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+
+    if (pDevice->seek(0)) {
+        hash.addData(pDevice);
+    }
+
+    hash.addData(getEngineName().toUtf8());
+    hash.addData(getDatabaseSnapshot(pScanOptions)->sFingerprint.toLatin1());
+    hash.addData(getScanOptionsFingerprint(pScanOptions).toUtf8());
+
+    return hash.result().toHex();
+}
+
+qint64 XScanEngine::_getResultCacheBase(QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct)
+{
+    qint64 nResult = 0;
+
+    // Same condition as the memory copy in _scanProcess: offsets of a copy start at 0, otherwise they are relative to the root device
+    if ((pDevice->size() > XBinary::getFileBufferSize(pPdStruct)) || (pDevice->property("Memory").toULongLong() != 0)) {
+        nResult = XIODevice::getInitLocation(pDevice);
+    }
+
+    return nResult;
+}
+
+void XScanEngine::_rebaseResultCacheRecords(QList<SCANSTRUCT> *pListRecords, qint64 nDelta)
+{
+    if (nDelta) {
+        QMap<QString, SCANID> mapIds;
+
+        qint32 nNumberOfRecords = pListRecords->count();
+
+        for (qint32 i = 0; i < nNumberOfRecords; i++) {
+            mapIds.insert(pListRecords->at(i).id.sUuid, pListRecords->at(i).id);
+        }
+
+        for (qint32 i = 0; i < nNumberOfRecords; i++) {
+            SCANSTRUCT &scanStruct = (*pListRecords)[i];
+
+            // Parent ids copied from a result id carry its location; sub-part ids keep their offsets inside the parent
+            if (mapIds.contains(scanStruct.parentId.sUuid)) {
+                const SCANID &parentResultId = mapIds[scanStruct.parentId.sUuid];
+
+                if ((parentResultId.nOffset == scanStruct.parentId.nOffset) && (parentResultId.filePart == scanStruct.parentId.filePart)) {
+                    scanStruct.parentId.nOffset += nDelta;
+                }
+            }
+
+            scanStruct.id.nOffset += nDelta;
+        }
+    }
+}
+
+bool XScanEngine::_initSubScans(SUBSCAN_QUEUE *pQueue)
+{
+    if ((pQueue->nNumberOfThreads > 1) && (pQueue->pThreadPool == nullptr)) {
+        // Same scheme as XScanEngineProcess: one clone per worker
+        for (qint32 i = 0; i < pQueue->nNumberOfThreads; i++) {
+            XScanEngine *pEngine = clone();
+
+            if (!pEngine) {
+                break;
+            }
+
+            pQueue->listEngines.append(pEngine);
+            pQueue->listFreeEngines.append(pEngine);
+        }
+
+        if (pQueue->listEngines.isEmpty()) {
+            // Not cloneable: the caller scans serially on this engine
+            pQueue->nNumberOfThreads = 0;
+        } else {
+            pQueue->nNumberOfThreads = pQueue->listEngines.count();
+            pQueue->pThreadPool = new QThreadPool;
+            pQueue->pThreadPool->setMaxThreadCount(pQueue->nNumberOfThreads);
+
+            if (pQueue->pWatchdog == nullptr) {
+                pQueue->pWatchdog = new XScanWatchdog;
+                pQueue->bIsWatchdogOwned = true;
+            }
+        }
+    }
+
+    return (pQueue->pThreadPool != nullptr);
+}
+
+void XScanEngine::_addSubScan(SUBSCAN_QUEUE *pQueue, QIODevice *pDevice, bool bFileBuffer, const SCANID &scanId, const SCAN_OPTIONS &options,
+                              XBinary::PDSTRUCT *pPdStruct)
+{
+    // Bounded window: a waiting task holds an unpacked record
+    qint32 nMaxInFlight = pQueue->nNumberOfThreads * 2;
+    qint32 nNumberOfTasks = pQueue->listTasks.count();
+
+    while ((nNumberOfTasks - pQueue->nNumberOfFinished) >= nMaxInFlight) {
+        // The watchdog forwards a stop of pPdStruct to the running tasks
+        pQueue->listFutures[pQueue->nNumberOfFinished].waitForFinished();
+        pQueue->nNumberOfFinished++;
+    }
+
+    SUBSCAN_TASK *pTask = new SUBSCAN_TASK;
+    pTask->pDevice = pDevice;
+    pTask->bFileBuffer = bFileBuffer;
+    pTask->scanId = scanId;
+    pTask->options = options;
+    pTask->options.nNumberOfSubScanThreads = 0;  // Nested sub-scans stay on the worker
+    pTask->scanResult = {};
+    pTask->pdStruct = XBinary::createPdStruct();
+    pTask->nWatch = pQueue->pWatchdog->add(&(pTask->pdStruct), pPdStruct, 0);
+
+    pQueue->listTasks.append(pTask);
+    pQueue->listFutures.append(QtConcurrent::run(pQueue->pThreadPool, [pQueue, pTask]() {
+        if (XBinary::isPdStructNotCanceled(&(pTask->pdStruct))) {
+            pQueue->mutexEngines.lock();
+            XScanEngine *pEngine = pQueue->listFreeEngines.takeLast();
+            pQueue->mutexEngines.unlock();
+
+            // Direct: collected on the worker, the parent emits them in dispatch order
+            QList<QMetaObject::Connection> listConnections;
+            listConnections.append(connect(pEngine, &XScanEngine::errorMessage, pEngine,
+                                           [pTask](const QString &sText) { pTask->listMessages.append(qMakePair(QtCriticalMsg, sText)); }, Qt::DirectConnection));
+            listConnections.append(connect(pEngine, &XScanEngine::warningMessage, pEngine,
+                                           [pTask](const QString &sText) { pTask->listMessages.append(qMakePair(QtWarningMsg, sText)); }, Qt::DirectConnection));
+            listConnections.append(connect(pEngine, &XScanEngine::infoMessage, pEngine,
+                                           [pTask](const QString &sText) { pTask->listMessages.append(qMakePair(QtInfoMsg, sText)); }, Qt::DirectConnection));
+
+            pEngine->scanProcess(pTask->pDevice, &(pTask->scanResult), pTask->scanId, &(pTask->options), false, &(pTask->pdStruct));
+
+            qint32 nNumberOfConnections = listConnections.count();
+
+            for (qint32 i = 0; i < nNumberOfConnections; i++) {
+                disconnect(listConnections.at(i));
+            }
+
+            pQueue->mutexEngines.lock();
+            pQueue->listFreeEngines.append(pEngine);
+            pQueue->mutexEngines.unlock();
+        }
+
+        pQueue->pWatchdog->remove(pTask->nWatch);
+
+        if (pTask->bFileBuffer) {
+            XBinary::freeFileBuffer(&(pTask->pDevice));
+        } else {
+            delete pTask->pDevice;
+            pTask->pDevice = nullptr;
+        }
+    }));
+}
+
+void XScanEngine::_finishSubScans(SUBSCAN_QUEUE *pQueue, SCAN_RESULT *pScanResult, XBinary::PDSTRUCT *pPdStruct)
+{
+    Q_UNUSED(pPdStruct)  // A stop reaches the tasks through pQueue->pWatchdog
+
+    if (pQueue->pThreadPool) {
+        pQueue->pThreadPool->waitForDone();
+
+        delete pQueue->pThreadPool;
+        pQueue->pThreadPool = nullptr;
+    }
+
+    if (pQueue->bIsWatchdogOwned) {
+        delete pQueue->pWatchdog;
+        pQueue->pWatchdog = nullptr;
+        pQueue->bIsWatchdogOwned = false;
+    }
+
+    // Dispatch order is the order of the serial scan; the ids were set before dispatch
+    qint32 nNumberOfTasks = pQueue->listTasks.count();
+
+    for (qint32 i = 0; i < nNumberOfTasks; i++) {
+        SUBSCAN_TASK *pTask = pQueue->listTasks.at(i);
+
+        pScanResult->listRecords.append(pTask->scanResult.listRecords);
+        pScanResult->listErrors.append(pTask->scanResult.listErrors);
+        pScanResult->listDebugRecords.append(pTask->scanResult.listDebugRecords);
+        pScanResult->bIsSignatureTimeout = pScanResult->bIsSignatureTimeout || pTask->scanResult.bIsSignatureTimeout;
+
+        qint32 nNumberOfMessages = pTask->listMessages.count();
+
+        for (qint32 j = 0; j < nNumberOfMessages; j++) {
+            const QPair<QtMsgType, QString> &message = pTask->listMessages.at(j);
+
+            if (message.first == QtCriticalMsg) {
+                emit errorMessage(message.second);
+            } else if (message.first == QtWarningMsg) {
+                emit warningMessage(message.second);
+            } else {
+                emit infoMessage(message.second);
+            }
+        }
+
+        delete pTask;
+    }
+
+    pQueue->listTasks.clear();
+    pQueue->listFutures.clear();
+    pQueue->nNumberOfFinished = 0;
 
-            sd.close();
-        }
+    qint32 nNumberOfEngines = pQueue->listEngines.count();
+
+    for (qint32 i = 0; i < nNumberOfEngines; i++) {
+        delete pQueue->listEngines.at(i);
     }
 
-    return result;
+    pQueue->listEngines.clear();
+    pQueue->listFreeEngines.clear();
 }
 
-void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, bool bInit, XBinary::PDSTRUCT *pPdStruct)
+void XScanEngine::_scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, bool bInit, XBinary::PDSTRUCT *pPdStruct)
 {
     QElapsedTimer *pScanTimer = nullptr;
     qint64 nSize = pDevice->size();
@@ -2860,9 +4865,17 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
         pScanResult->nSize = nSize;
     }
 
+    // The detection passes over this device share its parsed formats
+    XScanParseCache parseCache;
+    SCAN_OPTIONS _scanOptions = *pScanOptions;
+    _scanOptions.pParseCache = &parseCache;
+    pScanOptions = &_scanOptions;
+
     QIODevice *_pDevice = pDevice;
     char *pBuffer = nullptr;
     QBuffer *bufDevice = nullptr;
+    QFile *pMappedFile = nullptr;
+    uchar *pMapped = nullptr;
 
     bool bMemory = false;
 
@@ -2875,24 +4888,54 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
     }
 
     if (bMemory) {
-        bufDevice = new QBuffer;
+        // File-backed devices are scanned through a read-only view of the file, no copy is made
+        QFile *pFile = qobject_cast<QFile *>(_pDevice);
 
-        pBuffer = new char[nSize];
+        if (pFile && nSize) {
+            pMapped = pFile->map(0, nSize);
 
-        if (nSize) {
-            XBinary::read_array_process(_pDevice, 0, pBuffer, nSize, pPdStruct);
+            if (pMapped) {
+                pMappedFile = pFile;
+            }
         }
 
-        bufDevice->setData(pBuffer, nSize);
-        bufDevice->open(QIODevice::ReadOnly);
+        bufDevice = new QBuffer;
+
+        if (pMapped) {
+            bufDevice->setData(QByteArray::fromRawData((char *)pMapped, nSize));
+            bufDevice->open(QIODevice::ReadOnly);
+
+            bufDevice->setProperty("Memory", (quint64)pMapped);
+        } else {
+            pBuffer = new char[nSize];
+
+            if (nSize) {
+                XBinary::read_array_process(_pDevice, 0, pBuffer, nSize, pPdStruct);
+            }
+
+            bufDevice->setData(pBuffer, nSize);
+            bufDevice->open(QIODevice::ReadOnly);
+
+            bufDevice->setProperty("Memory", (quint64)pBuffer);
+        }
 
-        bufDevice->setProperty("Memory", (quint64)pBuffer);
         bufDevice->setProperty("FileName", XBinary::getDeviceFileName(_pDevice));
 
         _pDevice = bufDevice;
     }
 
-    QSet<XBinary::FT> stFT = XFormats::getFileTypes(_pDevice, XBinary::FT_FLAG_FORMATS, pPdStruct);
+    QSet<XBinary::FT> stFT;
+
+    if (pScanOptions->stFileTypes.isEmpty()) {
+        stFT = _getFileTypes(_pDevice, pScanOptions, pPdStruct);
+    } else {
+        // Already detected by the isScanable probe of the parent
+        stFT = pScanOptions->stFileTypes;
+
+        if (pScanOptions->pProfiler) {
+            pScanOptions->pProfiler->addCount("getFileTypes (reused)");
+        }
+    }
 
     if (bInit || (pScanOptions->fileType == XBinary::FT_BINARY)) {
         if (pScanOptions->fileType != XBinary::FT_UNKNOWN) {
@@ -2903,128 +4946,128 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
     if (pScanOptions->bIsAllTypesScan) {
         if (stFT.contains(XBinary::FT_PE32) || stFT.contains(XBinary::FT_PE64) || stFT.contains(XBinary::FT_LE) || stFT.contains(XBinary::FT_LX) ||
             stFT.contains(XBinary::FT_NE)) {
-            _processDetect(0, pScanResult, _pDevice, parentId, XBinary::FT_MSDOS, pScanOptions, true, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, parentId, XBinary::FT_MSDOS, pScanOptions, true, pPdStruct);
         }
 
         if (stFT.contains(XBinary::FT_APK) || stFT.contains(XBinary::FT_IPA)) {
-            _processDetect(0, pScanResult, _pDevice, parentId, XBinary::FT_JAR, pScanOptions, true, pPdStruct);
-            _processDetect(0, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, parentId, XBinary::FT_JAR, pScanOptions, true, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
         }
 
         if (stFT.contains(XBinary::FT_JAR)) {
-            _processDetect(0, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
         }
 
         if (stFT.contains(XBinary::FT_DOS4G)) {
-            _processDetect(0, pScanResult, _pDevice, parentId, XBinary::FT_DOS16M, pScanOptions, true, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, parentId, XBinary::FT_DOS16M, pScanOptions, true, pPdStruct);
         }
     }
 
     XScanEngine::SCANID scanIdMain = {};
 
     if (stFT.contains(XBinary::FT_PE32)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PE32, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PE32, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_PE32;
 
         if (XPE::isNETPresent(_pDevice)) {
-            _processDetect(0, pScanResult, _pDevice, scanIdMain, XBinary::FT_CLI_ASSEMBLY, pScanOptions, false, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, scanIdMain, XBinary::FT_CLI_ASSEMBLY, pScanOptions, false, pPdStruct);
         }
     } else if (stFT.contains(XBinary::FT_PE64)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PE64, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PE64, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_PE64;
 
         if (XPE::isNETPresent(_pDevice)) {
-            _processDetect(0, pScanResult, _pDevice, scanIdMain, XBinary::FT_CLI_ASSEMBLY, pScanOptions, false, pPdStruct);
+            _processDetectProfiled(0, pScanResult, _pDevice, scanIdMain, XBinary::FT_CLI_ASSEMBLY, pScanOptions, false, pPdStruct);
         }
     } else if (stFT.contains(XBinary::FT_ELF32)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ELF32, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ELF32, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_ELF32;
     } else if (stFT.contains(XBinary::FT_ELF64)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ELF64, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ELF64, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_ELF64;
     } else if (stFT.contains(XBinary::FT_MACHO32)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHO32, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHO32, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_MACHO32;
     } else if (stFT.contains(XBinary::FT_MACHO64)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHO64, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHO64, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_MACHO64;
     } else if (stFT.contains(XBinary::FT_LX)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_LX, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_LX, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_LX;
     } else if (stFT.contains(XBinary::FT_LE)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_LE, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_LE, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_LE;
     } else if (stFT.contains(XBinary::FT_NE)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_NE, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_NE, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_NE;
     } else if (stFT.contains(XBinary::FT_DOS16M)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DOS16M, pScanOptions, false, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DOS16M, pScanOptions, false, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_DOS16M;
     } else if (stFT.contains(XBinary::FT_DOS4G)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DOS4G, pScanOptions, false, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DOS4G, pScanOptions, false, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_DOS4G;
     } else if (stFT.contains(XBinary::FT_MSDOS)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MSDOS, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MSDOS, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_MSDOS;
     } else if (stFT.contains(XBinary::FT_APK)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_APK, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_APK, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_APK;
     } else if (stFT.contains(XBinary::FT_IPA)) {
         // _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_IPA, pScanOptions, true, pPdStruct);
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_IPA;
     } else if (stFT.contains(XBinary::FT_JAR)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JAR, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JAR, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_JAR;
     } else if (stFT.contains(XBinary::FT_ZIP)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ZIP, pScanOptions, true, pPdStruct);
         //_processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_ZIP;
     } else if (stFT.contains(XBinary::FT_DEX)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DEX, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_DEX, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_DEX;
     } else if (stFT.contains(XBinary::FT_NPM)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_NPM, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_NPM, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_NPM;
     } else if (stFT.contains(XBinary::FT_MACHOFAT)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHOFAT, pScanOptions, false, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_MACHOFAT, pScanOptions, false, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_MACHOFAT;
     } else if (stFT.contains(XBinary::FT_BWDOS16M)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_BWDOS16M, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_BWDOS16M, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_BWDOS16M;
     } else if (stFT.contains(XBinary::FT_AMIGAHUNK)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_AMIGAHUNK, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_AMIGAHUNK, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_AMIGAHUNK;
     } else if (stFT.contains(XBinary::FT_PDF)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PDF, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PDF, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_PDF;
     } else if (stFT.contains(XBinary::FT_CFBF)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_CFBF, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_CFBF, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_CFBF;
     } else if (stFT.contains(XBinary::FT_RAR)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_RAR, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_RAR, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_RAR;
     } else if (stFT.contains(XBinary::FT_ISO9660)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ISO9660, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ISO9660, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_ISO9660;
     } else if (stFT.contains(XBinary::FT_JPEG)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JPEG, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JPEG, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_JPEG;
     } else if (stFT.contains(XBinary::FT_PNG)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PNG, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PNG, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_PNG;
     } else if (stFT.contains(XBinary::FT_JAVACLASS)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JAVACLASS, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_JAVACLASS, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_JAVACLASS;
     } else if (stFT.contains(XBinary::FT_PYC)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PYC, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_PYC, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_PYC;
     } else if (stFT.contains(XBinary::FT_COM)) {
         XScanEngine::SCAN_RESULT _scanResultCOM = {};
         XScanEngine::SCAN_RESULT _scanResultBinary = {};
 
         if (pScanOptions->bIsDeepScan) {
-            _processDetect(&scanIdMain, &_scanResultBinary, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, false, pPdStruct);
+            _processDetectProfiled(&scanIdMain, &_scanResultBinary, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, false, pPdStruct);
         }
 
         bool bIsBinary = _scanResultBinary.listRecords.count();
@@ -3033,7 +5076,7 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
             XCOM xcom(_pDevice);
 
             if (xcom.isValid(pPdStruct)) {
-                _processDetect(&scanIdMain, &_scanResultCOM, _pDevice, parentId, XBinary::FT_COM, pScanOptions, !bIsBinary, pPdStruct);
+                _processDetectProfiled(&scanIdMain, &_scanResultCOM, _pDevice, parentId, XBinary::FT_COM, pScanOptions, !bIsBinary, pPdStruct);
             }
         }
 
@@ -3045,12 +5088,14 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
         pScanResult->listErrors.append(_scanResultCOM.listErrors);
         pScanResult->listDebugRecords.append(_scanResultCOM.listDebugRecords);
 
+        pScanResult->bIsSignatureTimeout = pScanResult->bIsSignatureTimeout || _scanResultBinary.bIsSignatureTimeout || _scanResultCOM.bIsSignatureTimeout;
+
         if (bInit) pScanResult->ftInit = XBinary::FT_COM;
     } else if (stFT.contains(XBinary::FT_ARCHIVE) && (stFT.size() == 1)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ARCHIVE, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_ARCHIVE, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_ARCHIVE;
     } else if (stFT.contains(XBinary::FT_IMAGE) && (stFT.size() == 1)) {
-        _processDetect(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_IMAGE, pScanOptions, true, pPdStruct);
+        _processDetectProfiled(&scanIdMain, pScanResult, _pDevice, parentId, XBinary::FT_IMAGE, pScanOptions, true, pPdStruct);
         if (bInit) pScanResult->ftInit = XBinary::FT_IMAGE;
     } else {
         XScanEngine::SCAN_RESULT _scanResultCOM = {};
@@ -3063,13 +5108,13 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
                 XScanEngine::SCAN_OPTIONS _options = *pScanOptions;
                 _options.bIsVerbose = false;  // do not show Operation System
 
-                _processDetect(&scanIdMain, &_scanResultCOM, _pDevice, parentId, XBinary::FT_COM, &_options, false, pPdStruct);
+                _processDetectProfiled(&scanIdMain, &_scanResultCOM, _pDevice, parentId, XBinary::FT_COM, &_options, false, pPdStruct);
             }
         }
 
         bool bIsCOM = hasNonGenericCOMRecords(_scanResultCOM.listRecords);
 
-        _processDetect(&scanIdMain, &_scanResultBinary, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, !bIsCOM, pPdStruct);
+        _processDetectProfiled(&scanIdMain, &_scanResultBinary, _pDevice, parentId, XBinary::FT_BINARY, pScanOptions, !bIsCOM, pPdStruct);
 
         pScanResult->listRecords.append(_scanResultBinary.listRecords);
         pScanResult->listErrors.append(_scanResultBinary.listErrors);
@@ -3081,10 +5126,24 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
             pScanResult->listDebugRecords.append(_scanResultCOM.listDebugRecords);
         }
 
+        // A discarded COM result may still have decided bIsCOM
+        pScanResult->bIsSignatureTimeout = pScanResult->bIsSignatureTimeout || _scanResultBinary.bIsSignatureTimeout || _scanResultCOM.bIsSignatureTimeout;
+
         pScanResult->ftInit = XBinary::FT_BINARY;
     }
 
     if (!(pScanOptions->bCollection)) {
+        // Sub-scans run in place unless nNumberOfSubScanThreads is set; either way the results keep the serial order
+        SUBSCAN_QUEUE subScans;
+        subScans.nNumberOfThreads = pScanOptions->nNumberOfSubScanThreads;
+        subScans.pThreadPool = nullptr;
+        subScans.nNumberOfFinished = 0;
+        subScans.pWatchdog = pScanOptions->pWatchdog;
+        subScans.bIsWatchdogOwned = false;
+
+        // Workers cannot share the parent device; over memory each file part gets its own buffer, otherwise parts are scanned in place
+        char *pMemory = (char *)(_pDevice->property("Memory").toULongLong());
+
         if (pScanOptions->bIsArchivesScan) {
             qint32 nLimit = 20;
 
@@ -3121,9 +5180,10 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
                         if (pArchiveRecord) {
                             if (pArchive->unpackCurrent(&state, pArchiveRecord, pPdStruct)) {
                                 bool bScan = pScanOptions->bIsAggressiveScan;
+                                QSet<XBinary::FT> _stFT;
 
                                 if (!bScan) {
-                                    QSet<XBinary::FT> _stFT = XFormats::getFileTypes(pArchiveRecord, 0, -1, XBinary::FT_FLAG_FORMATS, pPdStruct);
+                                    _stFT = _getFileTypes(pArchiveRecord, pScanOptions, pPdStruct);
                                     bScan = isScanable(_stFT);
                                 }
 
@@ -3144,21 +5204,31 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
 
                                     XScanEngine::SCAN_OPTIONS _options = *pScanOptions;
                                     _options.fileType = XBinary::FT_UNKNOWN;
+                                    _options.stFileTypes = _stFT;
 
-                                    SCAN_RESULT scanResultArchiveRecord = {};
+                                    if (_initSubScans(&subScans)) {
+                                        // The task frees the record
+                                        _addSubScan(&subScans, pArchiveRecord, true, scanIdSub, _options, pPdStruct);
+                                        pArchiveRecord = nullptr;
+                                    } else {
+                                        SCAN_RESULT scanResultArchiveRecord = {};
 
-                                    scanProcess(pArchiveRecord, &scanResultArchiveRecord, scanIdSub, &_options, false, pPdStruct);
+                                        scanProcess(pArchiveRecord, &scanResultArchiveRecord, scanIdSub, &_options, false, pPdStruct);
 
-                                    pScanResult->listRecords.append(scanResultArchiveRecord.listRecords);
-                                    pScanResult->listErrors.append(scanResultArchiveRecord.listErrors);
-                                    pScanResult->listDebugRecords.append(scanResultArchiveRecord.listDebugRecords);
+                                        pScanResult->listRecords.append(scanResultArchiveRecord.listRecords);
+                                        pScanResult->listErrors.append(scanResultArchiveRecord.listErrors);
+                                        pScanResult->listDebugRecords.append(scanResultArchiveRecord.listDebugRecords);
+                                        pScanResult->bIsSignatureTimeout = pScanResult->bIsSignatureTimeout || scanResultArchiveRecord.bIsSignatureTimeout;
+                                    }
 
                                     nCurrentIndex++;
                                 }
                             }
                         }
 
-                        XBinary::freeFileBuffer(&pArchiveRecord);
+                        if (pArchiveRecord) {
+                            XBinary::freeFileBuffer(&pArchiveRecord);
+                        }
 
                         if (nCurrentIndex > nLimit) {
                             break;
@@ -3182,6 +5252,11 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
             }
         }
 
+        if (pMemory == nullptr) {
+            // File parts are scanned in place, so the archive records have to be merged before them
+            _finishSubScans(&subScans, pScanResult, pPdStruct);
+        }
+
         QList<XBinary::FPART> listFileParts;
 
         if (pScanOptions->bIsResourcesScan || pScanOptions->bIsRecursiveScan) {
@@ -3213,6 +5288,7 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
 
                     if (subDevice.open(QIODevice::ReadOnly)) {
                         bool bScan = (filePart.filePart == XBinary::FILEPART_OVERLAY);
+                        QSet<XBinary::FT> _stFT;
 
                         if (!bScan) {
                             if (nCurrentIndex <= nLimit) {
@@ -3220,7 +5296,7 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
                                     bScan = pScanOptions->bIsAggressiveScan;
 
                                     if (!bScan) {
-                                        QSet<XBinary::FT> _stFT = XFormats::getFileTypes(&subDevice, 0, -1, XBinary::FT_FLAG_FORMATS, pPdStruct);
+                                        _stFT = _getFileTypes(&subDevice, pScanOptions, pPdStruct);
                                         bScan = isScanable(_stFT);
                                     }
                                 }
@@ -3238,18 +5314,43 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
 
                             XScanEngine::SCAN_OPTIONS _options = *pScanOptions;
                             _options.fileType = XBinary::FT_UNKNOWN;
+                            _options.stFileTypes = _stFT;
 
                             if (filePart.filePart == XBinary::FILEPART_RESOURCE) {
                                 _options.sScanID = filePart.mapProperties.value(XBinary::FPART_PROP_RESOURCEID).toString();
                             }
 
-                            SCAN_RESULT scanResultFilePart = {};
+                            QBuffer *pFilePart = nullptr;
+
+                            if (pMemory) {
+                                // A view into the buffered parent, the child scan does not copy it again.
+                                // Its offsets start at 0 like those of the copy it replaces, on both paths below
+                                pFilePart = new QBuffer;
+                                pFilePart->setData(QByteArray::fromRawData(pMemory + filePart.nFileOffset, filePart.nFileSize));
+                                pFilePart->open(QIODevice::ReadOnly);
+                                pFilePart->setProperty("IsFilePartRecord", true);
+                                pFilePart->setProperty("FileName", subDevice.property("FileName"));
+                                pFilePart->setProperty("Memory", (quint64)(pMemory + filePart.nFileOffset));
+                            }
+
+                            if (pFilePart && _initSubScans(&subScans)) {
+                                _addSubScan(&subScans, pFilePart, false, scanIdSub, _options, pPdStruct);
+                            } else {
+                                SCAN_RESULT scanResultFilePart = {};
+
+                                if (pFilePart) {
+                                    scanProcess(pFilePart, &scanResultFilePart, scanIdSub, &_options, false, pPdStruct);
 
-                            scanProcess(&subDevice, &scanResultFilePart, scanIdSub, &_options, false, pPdStruct);
+                                    delete pFilePart;
+                                } else {
+                                    scanProcess(&subDevice, &scanResultFilePart, scanIdSub, &_options, false, pPdStruct);
+                                }
 
-                            pScanResult->listRecords.append(scanResultFilePart.listRecords);
-                            pScanResult->listErrors.append(scanResultFilePart.listErrors);
-                            pScanResult->listDebugRecords.append(scanResultFilePart.listDebugRecords);
+                                pScanResult->listRecords.append(scanResultFilePart.listRecords);
+                                pScanResult->listErrors.append(scanResultFilePart.listErrors);
+                                pScanResult->listDebugRecords.append(scanResultFilePart.listDebugRecords);
+                                pScanResult->bIsSignatureTimeout = pScanResult->bIsSignatureTimeout || scanResultFilePart.bIsSignatureTimeout;
+                            }
 
                             subDevice.close();
 
@@ -3263,6 +5364,8 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
 
             XBinary::setPdStructFinished(pPdStruct, nFreeIndex);
         }
+
+        _finishSubScans(&subScans, pScanResult, pPdStruct);
     }
 
     QString sLastError = XBinary::getPdStructErrorString(pPdStruct);
@@ -3408,6 +5511,10 @@ void XScanEngine::scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCAN
     if (pBuffer) {
         delete[] pBuffer;
     }
+
+    if (pMapped) {
+        pMappedFile->unmap(pMapped);
+    }
 }
 
 QString XScanEngine::convertPath(QIODevice *pDevice, const XScanEngine::SCANSTRUCT &scanStruct, const QString &sString, XBinary::PDSTRUCT *pPdStruct)
@@ -4009,6 +6116,11 @@ XScanEngine::SCANENGINETYPE XScanEngine::getEngineType()
     return SCANENGINETYPE_UNKNOWN;
 }
 
+XScanEngine *XScanEngine::clone()
+{
+    return nullptr;
+}
+
 bool XScanEngine::isSignatureFileValid(const QString &sSignatureFilePath)
 {
     Q_UNUSED(sSignatureFilePath)
@@ -4021,6 +6133,11 @@ bool XScanEngine::isDatabaseUsing()
     return false;
 }
 
+bool XScanEngine::isDatabaseLoadReentrant()
+{
+    return false;
+}
+
 QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::getSignaturesFromData(const QString &sData, const QString &sSignatureFilePath, XBinary::FT fileType,
                                                                         XBinary::PDSTRUCT *pPdStruct)
 {
@@ -4039,6 +6156,39 @@ QList<XScanEngine::SIGNATURE_RECORD> XScanEngine::getSignaturesFromData(const QS
     return listResult;
 }
 
+void XScanEngine::_processDetectProfiled(SCANID *pScanID, SCAN_RESULT *pScanResult, QIODevice *pDevice, const SCANID &parentId, XBinary::FT fileType,
+                                         SCAN_OPTIONS *pOptions, bool bAddUnknown, XBinary::PDSTRUCT *pPdStruct)
+{
+    if (pOptions->pProfiler) {
+        QElapsedTimer timer;
+        timer.start();
+
+        _processDetect(pScanID, pScanResult, pDevice, parentId, fileType, pOptions, bAddUnknown, pPdStruct);
+
+        pOptions->pProfiler->addSample(XScanProfiler::CATEGORY_DETECT, XBinary::fileTypeIdToString(fileType), timer.nsecsElapsed());
+    } else {
+        _processDetect(pScanID, pScanResult, pDevice, parentId, fileType, pOptions, bAddUnknown, pPdStruct);
+    }
+}
+
+QSet<XBinary::FT> XScanEngine::_getFileTypes(QIODevice *pDevice, SCAN_OPTIONS *pOptions, XBinary::PDSTRUCT *pPdStruct)
+{
+    QSet<XBinary::FT> stResult;
+
+    if (pOptions->pProfiler) {
+        QElapsedTimer timer;
+        timer.start();
+
+        stResult = XFormats::getFileTypes(pDevice, 0, -1, XBinary::FT_FLAG_FORMATS, pPdStruct);
+
+        pOptions->pProfiler->addSample(XScanProfiler::CATEGORY_DETECT, "getFileTypes", timer.nsecsElapsed());
+    } else {
+        stResult = XFormats::getFileTypes(pDevice, 0, -1, XBinary::FT_FLAG_FORMATS, pPdStruct);
+    }
+
+    return stResult;
+}
+
 void XScanEngine::_errorMessage(SCAN_OPTIONS *pOptions, const QString &sErrorMessage)
 {
     Q_UNUSED(pOptions)
@@ -4060,6 +6210,61 @@ void XScanEngine::_errorMessage(SCAN_OPTIONS *pOptions, const QString &sErrorMes
     emit errorMessage(sErrorMessage);
 }
 
+void XScanEngine::_addSignatureTimeout(SCAN_RESULT *pScanResult, SCAN_OPTIONS *pOptions, const QString &sSignature)
+{
+    pScanResult->bIsSignatureTimeout = true;
+
+    ERROR_RECORD errorRecord = {};
+    errorRecord.sScript = sSignature;
+    errorRecord.sErrorString = QString("%1: %2 ms").arg(tr("Timeout")).arg(pOptions->nSignatureTimeout);
+
+    pScanResult->listErrors.append(errorRecord);
+}
+
+QBitArray XScanEngine::getSignatureCandidates(Binary_Script *pBinaryScript, SCAN_OPTIONS *pOptions)
+{
+    QBitArray baResult;
+
+    QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = getDatabaseSnapshot(pOptions);
+
+    if (pOptions->bUseLiteralPrefilter && (pDatabase->literalIndex.getNumberOfSignatures() == pDatabase->listSignatures.count())) {
+        baResult = pDatabase->literalIndex.getCandidates(pBinaryScript->getHeaderBytes(), pBinaryScript->getEntryPointBytes(), pBinaryScript->getOverlayBytes());
+    }
+
+    if (pOptions->bVerifyLiteralPrefilter) {
+        // Everything runs; the filtered set is kept for _verifyLiteralPrefilter
+        pBinaryScript->setLiteralCandidates(baResult);
+        baResult.clear();
+    }
+
+    if (baResult.isEmpty()) {
+        baResult.resize(pDatabase->listSignatures.count());
+        baResult.fill(true);
+    }
+
+    return baResult;
+}
+
+void XScanEngine::_verifyLiteralPrefilter(Binary_Script *pBinaryScript, const QList<qint32> &listDetectedSignatures, SCAN_OPTIONS *pOptions)
+{
+    QBitArray baCandidates = pBinaryScript->getLiteralCandidates();
+
+    // Empty if the prefilter was off: nothing to compare
+    if (pOptions->bVerifyLiteralPrefilter && (!baCandidates.isEmpty())) {
+        QSharedPointer<const DATABASE_SNAPSHOT> pDatabase = getDatabaseSnapshot(pOptions);
+
+        qint32 nNumberOfSignatures = listDetectedSignatures.count();
+
+        for (qint32 i = 0; i < nNumberOfSignatures; i++) {
+            qint32 nIndex = listDetectedSignatures.at(i);
+
+            if ((nIndex >= 0) && (nIndex < baCandidates.size()) && (nIndex < pDatabase->listSignatures.count()) && (!baCandidates.testBit(nIndex))) {
+                _warningMessage(pOptions, QString("%1: %2: %3").arg(tr("Literal prefilter"), tr("missing"), pDatabase->listSignatures.at(nIndex).sName));
+            }
+        }
+    }
+}
+
 void XScanEngine::_warningMessage(SCAN_OPTIONS *pOptions, const QString &sWarningMessage)
 {
     Q_UNUSED(pOptions)
@@ -4329,10 +6534,18 @@ bool XScanEngine::compareJson(const QString &sJson1, const QString &sJson2)
 }
 
 XScanEngine::TEST_RESULT XScanEngine::test(const QString &sDirectoryName)
+{
+    TEST_OPTIONS testOptions = getDefaultTestOptions();
+
+    return test(sDirectoryName, &testOptions);
+}
+
+XScanEngine::TEST_RESULT XScanEngine::test(const QString &sDirectoryName, const TEST_OPTIONS *pTestOptions, XBinary::PDSTRUCT *pPdStruct)
 {
     TEST_RESULT result = {};
     result.nTotal = 0;
     result.nErrors = 0;
+    result.nRegressions = 0;
 
     QString sJsonFileName = sDirectoryName + QDir::separator() + "tests.json";
     QFile jsonFile(sJsonFileName);
@@ -4362,129 +6575,344 @@ XScanEngine::TEST_RESULT XScanEngine::test(const QString &sDirectoryName)
     QJsonArray testCases = jsonObject.value("testCases").toArray();
     result.nTotal = testCases.count();
 
-    XBinary::PDSTRUCT pdStruct = {};
-    pdStruct.bIsStop = false;
+    QElapsedTimer timer;
+    timer.start();
 
-    SCAN_OPTIONS scanOptions = getDefaultOptions(0);
+    qint32 nNumberOfThreads = pTestOptions->nNumberOfThreads;
 
-    for (qint32 i = 0; i < testCases.count(); i++) {
-        QJsonObject testCase = testCases.at(i).toObject();
-        QString sZipPath = testCase.value("zipPath").toString();
-        QString sExpectedDetect = testCase.value("expectedDetect").toString();
+    if (nNumberOfThreads <= 0) {
+        nNumberOfThreads = QThread::idealThreadCount();
+    }
 
-        QString sFullZipPath = sDirectoryName + QDir::separator() + sZipPath;
+    nNumberOfThreads = qMax(1, qMin(nNumberOfThreads, result.nTotal));
 
-        QFile zipFile(sFullZipPath);
-        if (!zipFile.exists()) {
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "ZIP file not found";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
-        }
+    // Same scheme as XScanEngineProcess: one clone per worker, or this engine on a single worker
+    QList<XScanEngine *> listEngines;
+    QList<XScanEngine *> listFreeEngines;
+    QMutex mutexEngines;
 
-        if (!zipFile.open(QIODevice::ReadOnly)) {
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "Failed to open ZIP file";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
+    for (qint32 i = 0; i < nNumberOfThreads; i++) {
+        XScanEngine *pEngine = clone();
+
+        if (!pEngine) {
+            break;
         }
 
-        XZip xzip(&zipFile);
-        QList<XArchive::RECORD> listRecords = xzip.getRecords(-1, &pdStruct);
+        connect(pEngine, SIGNAL(errorMessage(QString)), this, SIGNAL(errorMessage(QString)));
+        connect(pEngine, SIGNAL(warningMessage(QString)), this, SIGNAL(warningMessage(QString)));
+        connect(pEngine, SIGNAL(infoMessage(QString)), this, SIGNAL(infoMessage(QString)));
 
-        if (listRecords.isEmpty()) {
-            zipFile.close();
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "No files in ZIP archive";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
-        }
+        listEngines.append(pEngine);
+        listFreeEngines.append(pEngine);
+    }
 
-        XArchive::RECORD record = listRecords.at(0);
+    // An engine that cannot be cloned is never run from two threads
+    nNumberOfThreads = qMax(1, listEngines.count());
 
-        QByteArray baFileData;
-        QBuffer buffer(&baFileData);
+    QVector<TEST_CASE_RECORD> listCases(result.nTotal);
 
-        if (!buffer.open(QIODevice::WriteOnly)) {
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "Cannot create unpack buffer";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
-        }
+    // Forwards a stop of pPdStruct to the running cases
+    XScanWatchdog watchdog;
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(nNumberOfThreads);
+
+    QList<QFuture<void>> listFutures;
 
-        XBinary::UNPACK_STATE state = {};
-        QMap<XBinary::UNPACK_PROP, QVariant> mapProperties;
-        mapProperties[XBinary::UNPACK_PROP_PASSWORD] = "DetectItEasy";
+    for (qint32 i = 0; i < result.nTotal; i++) {
+        QJsonObject jsonTestCase = testCases.at(i).toObject();
+        TEST_CASE_RECORD *pRecord = &(listCases[i]);
 
-        bool bExtracted = false;
+        listFutures.append(QtConcurrent::run(&threadPool, [this, sDirectoryName, jsonTestCase, pRecord, pPdStruct, &listFreeEngines, &mutexEngines, &watchdog]() {
+            if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+                pRecord->sZipPath = jsonTestCase.value("zipPath").toString();
+                pRecord->sExpectedDetect = jsonTestCase.value("expectedDetect").toString();
+                pRecord->sErrorMessage = "Canceled";
+                pRecord->nBaselineTime = -1;
 
-        if (xzip.initUnpack(&state, mapProperties, &pdStruct)) {
-            if (xzip.unpackCurrent(&state, &buffer, &pdStruct)) {
-                bExtracted = true;
+                return;
             }
-            xzip.finishUnpack(&state, &pdStruct);
-        }
 
-        buffer.close();
-        zipFile.close();
+            XScanEngine *pEngine = this;
 
-        if (!bExtracted || baFileData.isEmpty()) {
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "Failed to extract file from ZIP";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
-        }
+            mutexEngines.lock();
+            if (!listFreeEngines.isEmpty()) {
+                pEngine = listFreeEngines.takeLast();
+            }
+            mutexEngines.unlock();
 
-        QBuffer scanBuffer(&baFileData);
-        if (!scanBuffer.open(QIODevice::ReadOnly)) {
-            TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = "Failed to open buffer for scanning";
-            result.listFailed.append(failedRecord);
-            result.nErrors++;
-            continue;
-        }
+            // Progress slots of a shared PDSTRUCT are not thread-safe, so each case gets its own
+            XBinary::PDSTRUCT pdStruct = XBinary::createPdStruct();
+            qint32 nWatch = -1;
+
+            if (pPdStruct) {
+                nWatch = watchdog.add(&pdStruct, pPdStruct, 0);
+            }
+
+            *pRecord = _testCase(pEngine, sDirectoryName, jsonTestCase, &pdStruct);
+
+            if (nWatch != -1) {
+                watchdog.remove(nWatch);
+            }
+
+            if (pEngine != this) {
+                mutexEngines.lock();
+                listFreeEngines.append(pEngine);
+                mutexEngines.unlock();
+            }
+        }));
+    }
+
+    threadPool.waitForDone();
+
+    qint32 nNumberOfEngines = listEngines.count();
+
+    for (qint32 i = 0; i < nNumberOfEngines; i++) {
+        delete listEngines.at(i);
+    }
+
+    QMap<QString, qint64> mapBaseline;
+
+    if (pTestOptions->sBaselineFileName != "") {
+        mapBaseline = _loadTestBaseline(pTestOptions->sBaselineFileName);
+    }
+
+    for (qint32 i = 0; i < result.nTotal; i++) {
+        TEST_CASE_RECORD record = listCases.at(i);
 
-        SCAN_RESULT scanResult = scanDevice(&scanBuffer, &scanOptions, &pdStruct);
-        scanBuffer.close();
+        if (record.bSuccess && mapBaseline.contains(record.sZipPath)) {
+            record.nBaselineTime = mapBaseline.value(record.sZipPath);
 
-        QString sDetectResult = createShortResultString(&scanOptions, scanResult);
+            qint64 nLimit = record.nBaselineTime + qMax(pTestOptions->nRegressionMinTime, (record.nBaselineTime * pTestOptions->nRegressionPercent) / 100);
+
+            if (record.nScanTime > nLimit) {
+                record.bRegression = true;
+                result.nRegressions++;
+            }
+        }
 
-        if (sDetectResult == sExpectedDetect) {
+        if (record.bSuccess) {
             TEST_SUCCESS_RECORD successRecord = {};
-            successRecord.sZipPath = sZipPath;
-            successRecord.sExpectedDetect = sExpectedDetect;
-            successRecord.nScanTime = scanResult.nScanTime;
+            successRecord.sZipPath = record.sZipPath;
+            successRecord.sExpectedDetect = record.sExpectedDetect;
+            successRecord.nScanTime = record.nScanTime;
+            successRecord.nElapsedTime = record.nElapsedTime;
             result.listSuccess.append(successRecord);
         } else {
             TEST_FAILED_RECORD failedRecord = {};
-            failedRecord.sZipPath = sZipPath;
-            failedRecord.sExpectedDetect = sExpectedDetect;
-            failedRecord.sErrorMessage = QString("Expected: '%1', Got: '%2'").arg(sExpectedDetect).arg(sDetectResult);
+            failedRecord.sZipPath = record.sZipPath;
+            failedRecord.sExpectedDetect = record.sExpectedDetect;
+            failedRecord.sErrorMessage = record.sErrorMessage;
+            failedRecord.nElapsedTime = record.nElapsedTime;
             result.listFailed.append(failedRecord);
             result.nErrors++;
         }
+
+        result.listCases.append(record);
+    }
+
+    result.nElapsedTime = timer.elapsed();
+
+    return result;
+}
+
+XScanEngine::TEST_OPTIONS XScanEngine::getDefaultTestOptions()
+{
+    TEST_OPTIONS result = {};
+    result.nNumberOfThreads = 0;
+    result.nRegressionPercent = 25;
+    result.nRegressionMinTime = 50;
+
+    return result;
+}
+
+bool XScanEngine::saveTestBaseline(const QString &sFileName, const TEST_RESULT &testResult)
+{
+    QJsonArray jsonCases;
+
+    qint32 nNumberOfCases = testResult.listCases.count();
+
+    for (qint32 i = 0; i < nNumberOfCases; i++) {
+        const TEST_CASE_RECORD &record = testResult.listCases.at(i);
+
+        // Times of failed cases say nothing about the detect that should have matched
+        if (record.bSuccess) {
+            QJsonObject jsonCase;
+            jsonCase["zipPath"] = record.sZipPath;
+            jsonCase["scanTime"] = record.nScanTime;
+
+            jsonCases.append(jsonCase);
+        }
+    }
+
+    QJsonObject jsonObject;
+    jsonObject["description"] = "XScanEngine test baseline";
+    jsonObject["testCases"] = jsonCases;
+
+    QFile file(sFileName);
+
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        return false;
+    }
+
+    QByteArray baJson = QJsonDocument(jsonObject).toJson(QJsonDocument::Indented);
+    bool bResult = (file.write(baJson.constData(), baJson.size()) == baJson.size());
+    file.close();
+
+    return bResult;
+}
+
+QString XScanEngine::testResultToString(const TEST_RESULT &testResult)
+{
+    QString sResult;
+
+    qint32 nNumberOfCases = testResult.listCases.count();
+
+    for (qint32 i = 0; i < nNumberOfCases; i++) {
+        const TEST_CASE_RECORD &record = testResult.listCases.at(i);
+
+        QString sStatus = record.bSuccess ? (record.bRegression ? "SLOW" : "PASS") : "FAIL";
+
+        sResult += QString("%1 %2 %3 ms").arg(sStatus, record.sZipPath, QString::number(record.nElapsedTime));
+
+        if (record.bRegression) {
+            sResult += QString(" (scan %1 ms, baseline %2 ms)").arg(record.nScanTime).arg(record.nBaselineTime);
+        }
+
+        if (!record.bSuccess) {
+            sResult += QString(": %1").arg(record.sErrorMessage);
+        }
+
+        sResult += "\n";
+    }
+
+    sResult += QString("Total: %1, Passed: %2, Failed: %3, Regressions: %4, Time: %5 ms\n")
+                   .arg(testResult.nTotal)
+                   .arg(testResult.nTotal - testResult.nErrors)
+                   .arg(testResult.nErrors)
+                   .arg(testResult.nRegressions)
+                   .arg(testResult.nElapsedTime);
+
+    return sResult;
+}
+
+XScanEngine::TEST_CASE_RECORD XScanEngine::_testCase(XScanEngine *pEngine, const QString &sDirectoryName, const QJsonObject &jsonTestCase,
+                                                    XBinary::PDSTRUCT *pPdStruct)
+{
+    TEST_CASE_RECORD result = {};
+    result.sZipPath = jsonTestCase.value("zipPath").toString();
+    result.sExpectedDetect = jsonTestCase.value("expectedDetect").toString();
+    result.nBaselineTime = -1;
+
+    QElapsedTimer timer;
+    timer.start();
+
+    QString sFullZipPath = sDirectoryName + QDir::separator() + result.sZipPath;
+
+    QFile zipFile(sFullZipPath);
+    if (!zipFile.exists()) {
+        result.sErrorMessage = "ZIP file not found";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    if (!zipFile.open(QIODevice::ReadOnly)) {
+        result.sErrorMessage = "Failed to open ZIP file";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    XZip xzip(&zipFile);
+    QList<XArchive::RECORD> listRecords = xzip.getRecords(-1, pPdStruct);
+
+    if (listRecords.isEmpty()) {
+        zipFile.close();
+        result.sErrorMessage = "No files in ZIP archive";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    QByteArray baFileData;
+    QBuffer buffer(&baFileData);
+
+    if (!buffer.open(QIODevice::WriteOnly)) {
+        zipFile.close();
+        result.sErrorMessage = "Cannot create unpack buffer";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    XBinary::UNPACK_STATE state = {};
+    QMap<XBinary::UNPACK_PROP, QVariant> mapProperties;
+    mapProperties[XBinary::UNPACK_PROP_PASSWORD] = "DetectItEasy";
+
+    bool bExtracted = false;
+
+    if (xzip.initUnpack(&state, mapProperties, pPdStruct)) {
+        if (xzip.unpackCurrent(&state, &buffer, pPdStruct)) {
+            bExtracted = true;
+        }
+        xzip.finishUnpack(&state, pPdStruct);
+    }
+
+    buffer.close();
+    zipFile.close();
+
+    if (!bExtracted || baFileData.isEmpty()) {
+        result.sErrorMessage = "Failed to extract file from ZIP";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    QBuffer scanBuffer(&baFileData);
+    if (!scanBuffer.open(QIODevice::ReadOnly)) {
+        result.sErrorMessage = "Failed to open buffer for scanning";
+        result.nElapsedTime = timer.elapsed();
+        return result;
+    }
+
+    SCAN_OPTIONS scanOptions = getDefaultOptions(0);
+
+    SCAN_RESULT scanResult = pEngine->scanDevice(&scanBuffer, &scanOptions, pPdStruct);
+    scanBuffer.close();
+
+    result.sDetectResult = createShortResultString(&scanOptions, scanResult);
+    result.nScanTime = scanResult.nScanTime;
+    result.nElapsedTime = timer.elapsed();
+
+    if (result.sDetectResult == result.sExpectedDetect) {
+        result.bSuccess = true;
+    } else {
+        result.sErrorMessage = QString("Expected: '%1', Got: '%2'").arg(result.sExpectedDetect).arg(result.sDetectResult);
     }
 
     return result;
 }
 
+QMap<QString, qint64> XScanEngine::_loadTestBaseline(const QString &sFileName)
+{
+    QMap<QString, qint64> mapResult;
+
+    QFile file(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QJsonDocument jsonDoc = QJsonDocument::fromJson(file.readAll());
+        file.close();
+
+        QJsonArray jsonCases = jsonDoc.object().value("testCases").toArray();
+
+        qint32 nNumberOfCases = jsonCases.count();
+
+        for (qint32 i = 0; i < nNumberOfCases; i++) {
+            QJsonObject jsonCase = jsonCases.at(i).toObject();
+
+            mapResult.insert(jsonCase.value("zipPath").toString(), (qint64)jsonCase.value("scanTime").toDouble());
+        }
+    }
+
+    return mapResult;
+}
+
 bool XScanEngine::addTestCase(const QString &sJsonPath, const QString &sFilePath, const QString &sExpectedDetect)
 {
     // Validate input paths
@@ -67,10 +67,20 @@
 #include "xformats.h"
 #include "xoptions.h"
 #include "xzip.h"
+#include <QFileSystemWatcher>
 #include <QFutureWatcher>
+#include <QJsonObject>
 #include <QLoggingCategory>
+#include <QMutex>
 #include <QObject>
+#include <QReadWriteLock>
+#include <QThreadPool>
+#include <QTimer>
+#include <QSharedPointer>
 #include "xcompresseddevice.h"
+#include "xscanliteralindex.h"
+
+class XScanResultCache;
 
 typedef bool (*SCAN_ENGINE_CALLBACK)(const QString &sCurrentSignature, qint32 nNumberOfSignatures, qint32 nCurrentIndex, void *pUserData);
 
@@ -96,6 +106,9 @@ public:
         QString sVersion;
         bool bIsEP;
         bool bReadOnly;
+        QString sInitType;     // First argument of init(), counted by getStats
+        QStringList listTags;  // From db/_metadata, attached when the database is loaded
+        qint64 nPrio;          // sort_signature_prio key from sName, 0 if not computed
     };
 
     enum RECORD_TYPE {
@@ -1147,6 +1160,8 @@ public:
         QList<ERROR_RECORD> listErrors;
         QList<DEBUG_RECORD> listDebugRecords;
         QList<XHandler::RECORD> listHandlers;
+        bool bIsTimeout;           // Stopped by SCAN_OPTIONS::nFileTimeout, the results are partial
+        bool bIsSignatureTimeout;  // A signature ran out of SCAN_OPTIONS::nSignatureTimeout, see _addSignatureTimeout
     };
 
     enum SF {
@@ -1175,6 +1190,8 @@ public:
         DATABASE_CUSTOM = 4,
     };
 
+    struct DATABASE_SNAPSHOT;
+
     struct SCAN_OPTIONS {
         //        bool bEmulate; // TODO Check
         bool bIsDeepScan;
@@ -1194,6 +1211,7 @@ public:
         bool bResultAsCSV;
         bool bResultAsTSV;
         bool bResultAsPlainText;
+        bool bResultAsNDJSON;  // One compact JSON line per file, written as soon as the file is scanned
         bool bSubdirectories;
         bool bIsImage;
         bool bIsTest;
@@ -1238,6 +1256,18 @@ public:
         QString sCollectionCatalogFormat;
         QString sCollectionStartFile;  // Optional
         QString sScanID;  // Optional
+        qint32 nNumberOfThreads;  // Optional, directory scan workers (0 or 1 = serial)
+        qint32 nNumberOfSubScanThreads;  // Optional, workers for the archive records, resources and overlay of one file (0 or 1 = serial, or if clone() is nullptr)
+        bool bUseLiteralPrefilter;     // Optional, getSignatureCandidates() rules out signatures whose compare literals are absent
+        bool bVerifyLiteralPrefilter;  // Optional, run all signatures and report the detections the prefilter would have skipped
+        XScanProfiler *pProfiler;      // Optional, collects API, detection and signature timings (engines add CATEGORY_SIGNATURE samples)
+        XScanResultCache *pResultCache;  // Optional, reuses results of identical content; not used for collections
+        qint32 nFileTimeout;             // Optional, ms for one top-level file including its archive records and file parts (0 = no limit)
+        qint32 nSignatureTimeout;        // Optional, ms for one signature, see Binary_Script::startSignature (0 = no limit)
+        QSet<XBinary::FT> stFileTypes;   // Internal, file types of the device already detected by the parent scan (empty = detect)
+        XScanParseCache *pParseCache;    // Internal, set by _scanProcess for the detection passes over one device
+        XScanWatchdog *pWatchdog;        // Internal, set by scanProcess for the budgets of one top-level file
+        QSharedPointer<const DATABASE_SNAPSHOT> pDatabase;  // Internal, set by scanProcess: the signatures of one top-level scan
     };
 
     struct SCAN_DATA {
@@ -1248,19 +1278,51 @@ public:
         QString sZipPath;
         QString sExpectedDetect;
         qint64 nScanTime;
+        qint64 nElapsedTime;
     };
 
     struct TEST_FAILED_RECORD {
         QString sZipPath;
         QString sExpectedDetect;
         QString sErrorMessage;
+        qint64 nElapsedTime;
+    };
+
+    struct TEST_CASE_RECORD {
+        QString sZipPath;
+        QString sExpectedDetect;
+        QString sDetectResult;
+        QString sErrorMessage;
+        bool bSuccess;
+        qint64 nScanTime;
+        qint64 nElapsedTime;   // Extraction and scan, ms
+        qint64 nBaselineTime;  // -1 if the case is not in the baseline
+        bool bRegression;
+    };
+
+    struct TEST_OPTIONS {
+        qint32 nNumberOfThreads;    // 0 = QThread::idealThreadCount()
+        QString sBaselineFileName;  // Scan times saved by saveTestBaseline
+        qint32 nRegressionPercent;
+        qint64 nRegressionMinTime;  // ms; slower fast samples are jitter, not regressions
     };
 
     struct TEST_RESULT {
         qint32 nTotal;
         qint32 nErrors;
+        qint32 nRegressions;
+        qint64 nElapsedTime;
         QList<TEST_SUCCESS_RECORD> listSuccess;
         QList<TEST_FAILED_RECORD> listFailed;
+        QList<TEST_CASE_RECORD> listCases;  // In tests.json order
+    };
+
+    struct BENCHMARK_RECORD {
+        QString sName;
+        qint32 nIterations;
+        qint64 nTotalNs;
+        qint64 nMinNs;
+        qint64 nMaxNs;
     };
 
     XScanEngine(QObject *pParent = nullptr);
@@ -1286,6 +1348,14 @@ public:
         QList<DATABASE_STATE_RECORD> listRecords;
     };
 
+    struct DATABASE_RELOAD_RESULT {
+        bool bSuccess;
+        QList<QString> listAdded;  // Signature file paths
+        QList<QString> listChanged;
+        QList<QString> listRemoved;
+        qint64 nElapsedTime;
+    };
+
     // Signature metadata loaded from db/_metadata/<FileType>.txt (lines: "<signature-file>#<tag1,tag2,...>")
     struct METADATA_RECORD {
         XBinary::FT fileType;
@@ -1293,6 +1363,19 @@ public:
         QStringList listTags;
     };
 
+    // Loaded signatures and everything derived from them; immutable once published, engines and clones share one copy
+    struct DATABASE_SNAPSHOT {
+        QList<SIGNATURE_RECORD> listSignatures;
+        QList<METADATA_RECORD> listMetadata;
+        QList<QSharedPointer<QFile>> listCacheFiles;  // Mapped v7 caches, signature strings point into them
+        XScanLiteralIndex literalIndex;
+        QMap<XBinary::FT, QVector<qint32>> mapSignatureBuckets;  // Indexes into listSignatures per signature file type
+        QMap<XBinary::FT, qint32> mapNumberOfSignatures;         // Same buckets without "_init"
+        QHash<QString, qint32> mapSignatureIndexes;              // sFilePath -> index into listSignatures
+        QMap<QString, QVector<qint32>> mapTagSignatures;         // Metadata tag -> indexes into listSignatures
+        QString sFingerprint;                                    // Hash of listSignatures, part of the result cache key; set by _setDatabase
+    };
+
     DATABASE_STATE getDatabaseState(XScanEngine::SCAN_OPTIONS *pOptions);
 
     static QString databaseStateToJson(const DATABASE_STATE &databaseState);
@@ -1303,11 +1386,23 @@ public:
 
     QList<SIGNATURE_STATE> getSignatureStates();
     qint32 getNumberOfSignatures(XBinary::FT fileType);
-    QList<SIGNATURE_RECORD> *getSignatures();
+    // The published database; it stays valid and unchanged while the pointer is held, reloads publish a new one.
+    // Replaces the protected m_listSignatures and m_listMetadata that derived engines used to index.
+    // With pOptions of a running scan: the snapshot that scan started with
+    QSharedPointer<const DATABASE_SNAPSHOT> getDatabaseSnapshot(const SCAN_OPTIONS *pOptions = nullptr);
+    // getDatabaseSnapshot()->listSignatures of a snapshot the engine holds; valid until the next call after a reload.
+    // Read only: edits go through updateSignature. Scans and other threads use getDatabaseSnapshot()
+    const QList<SIGNATURE_RECORD> *getSignatures();
+    // Indexes into getSignatures() of the signatures that apply to fileType, in list order; a scan uses the mapSignatureBuckets of its own snapshot
+    QVector<qint32> getSignatureIndexes(XBinary::FT fileType);
 
     void initMetadata();
     void loadMetadata(const QString &sDatabasePath, XBinary::PDSTRUCT *pPdStruct = nullptr);
-    QList<METADATA_RECORD> *getMetadata();
+    const QList<METADATA_RECORD> *getMetadata();  // Same for getDatabaseSnapshot()->listMetadata
+    QList<QString> getMetadataTags();  // Sorted
+    // Indexes into getSignatures() in list order
+    QVector<qint32> getSignatureIndexesByTag(const QString &sTag);
+    QStringList getSignatureTags(const QString &sSignatureFilePath);
 
     SIGNATURE_RECORD getSignatureByFilePath(const QString &sSignatureFilePath);
     bool updateSignature(const QString &sSignatureFilePath, const QString &sText);
@@ -1357,6 +1452,8 @@ public:
 
     void scanProcess(QIODevice *pDevice, XScanEngine::SCAN_RESULT *pScanResult, XScanEngine::SCANID parentId, XScanEngine::SCAN_OPTIONS *pScanOptions, bool bInit,
                      XBinary::PDSTRUCT *pPdStruct);
+    QString getDatabaseFingerprint();
+    static QString getScanOptionsFingerprint(const SCAN_OPTIONS *pScanOptions);  // Only the options that change detection results
 
     QString convertPath(QIODevice *pDevice, const XScanEngine::SCANSTRUCT &scanStruct, const QString &sString, XBinary::PDSTRUCT *pPdStruct);
     static QString getAvailablePathVariables();
@@ -1383,38 +1480,192 @@ public:
                                     RECORD_NAME name = RECORD_NAME_UNKNOWN, const QString &sVersion = "", const QString &sInfo = "");
 
     TEST_RESULT test(const QString &sDirectoryName);
+    TEST_RESULT test(const QString &sDirectoryName, const TEST_OPTIONS *pTestOptions, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static TEST_OPTIONS getDefaultTestOptions();
+    static bool saveTestBaseline(const QString &sFileName, const TEST_RESULT &testResult);
+    static QString testResultToString(const TEST_RESULT &testResult);
     bool compareJson(const QString &sJson1, const QString &sJson2);
     static bool addTestCase(const QString &sJsonPath, const QString &sFilePath, const QString &sExpectedDetect);
     bool createTest(const QString &sFilePath, const QString sResultName, XScanEngine::SCAN_OPTIONS *pOptions, XBinary::PDSTRUCT *pPdStruct = nullptr);
 
+    // Compares the legacy v5 stream cache with the mapped cache on the loaded signatures
+    QList<BENCHMARK_RECORD> benchmarkDatabaseCache(qint32 nIterations, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // Compares a sequential database load with the thread-pooled one, cache bypassed
+    QList<BENCHMARK_RECORD> benchmarkDatabaseLoad(const QString &sDatabasePath, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // Compares lazy PE_Script construction with parsing every member up front on a PE corpus
+    static QList<BENCHMARK_RECORD> benchmarkPEScript(const QList<QString> &listFileNames, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // The format passes of an all types scan of each PE file, without and with XScanParseCache
+    static QList<BENCHMARK_RECORD> benchmarkParseCache(const QList<QString> &listFileNames, qint32 nIterations, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static QString benchmarkToString(const QList<BENCHMARK_RECORD> &listRecords);
+
     virtual QString getEngineName();
     virtual SCANENGINETYPE getEngineType();
+    // Returns a new engine sharing the loaded signatures for a parallel worker.
+    // nullptr means the engine cannot be cloned; parallel work then runs serially on this instance.
+    // An override returns a new instance of its own class built with the copy constructor, which shares the database snapshot,
+    // and copies its own settings. Each clone is driven by one worker thread at a time and deleted by the caller, so an engine
+    // must not keep per-scan state in members shared with other instances. SCAN_OPTIONS::nNumberOfThreads and
+    // nNumberOfSubScanThreads need it; _processDetect of a clone runs for a sub-scan with the parent's SCAN_OPTIONS::pDatabase.
+    virtual XScanEngine *clone();
     virtual bool isSignatureFileValid(const QString &sSignatureFilePath);
     virtual bool isDatabaseUsing();
+    // true if getSignaturesFromData may run on several threads at once; a directory database is then parsed on a pool
+    virtual bool isDatabaseLoadReentrant();
     virtual QList<SIGNATURE_RECORD> getSignaturesFromData(const QString &sData, const QString &sSignatureFilePath, XBinary::FT fileType, XBinary::PDSTRUCT *pPdStruct);
 
     bool loadDatabase(SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pPdStruct);
     bool _loadDatabase(const QString &sDatabasePath, DT databaseType);
+    // Loads the databases of the last loadDatabase() again and swaps them in; running scans finish on the old signatures
+    DATABASE_RELOAD_RESULT reloadDatabase(XBinary::PDSTRUCT *pPdStruct = nullptr);
+    // Opt-in: reloads on changes below the database paths of the last loadDatabase(), needs an event loop
+    bool startDatabaseWatcher();
+    void stopDatabaseWatcher();
+    bool isDatabaseWatcherActive();
 
 private:
-    void initDatabase();
-    bool loadDatabase(const QString &sDatabasePath, DT databaseType, bool bUseCache = true, XBinary::PDSTRUCT *pPdStruct = nullptr);
-    QList<SIGNATURE_RECORD> _loadDatabaseFromPath(const QString &sDatabasePath, DT databaseType, XBinary::FT fileType, XBinary::PDSTRUCT *pPdStruct);
-    QList<SIGNATURE_RECORD> _loadDatabaseFromArchive(XArchive *pArchive, QList<XArchive::RECORD> *pListRecords, DT databaseType, const QString &sPrefix,
-                                                     XBinary::FT fileType);  // TODO pdStruct
+    struct DATABASE_FOLDER {
+        QString sName;
+        XBinary::FT fileType;
+    };
+
+    struct DATABASE_FILE {
+        QString sFilePath;  // File path or archive record name
+        XBinary::FT fileType;
+        qint32 nRecordIndex;  // Archive record, -1 for files
+        qint64 nSize;
+        qint64 nMtime;
+    };
+
+    struct DATABASE_FILE_STATE {
+        QString sFilePath;
+        qint64 nSize;
+        qint64 nMtime;
+        QByteArray baHash;  // MD5, empty until the file was seen with a different size or mtime
+    };
+
+    // Fingerprints of the signature files behind a directory cache
+    struct DATABASE_MANIFEST {
+        quint32 nFileCount;  // Header values of the cache written with this manifest
+        quint64 nTotalSize;
+        qint64 nNewestMtime;
+        QList<DATABASE_FILE_STATE> listFiles;
+        QList<qint32> listRecordFiles;  // Per cached record, the index in listFiles of the file it was parsed from
+    };
+
+    // Database paths of the last loadDatabase(), used by reloadDatabase()
+    struct DATABASE_WATCH {
+        QString sMainDatabasePath;
+        QString sCustomDatabasePath;
+        bool bUseCustomDatabase;
+        bool bUseCache;
+    };
+
+    bool _loadDatabaseSnapshot(DATABASE_SNAPSHOT *pDatabase, XBinary::PDSTRUCT *pPdStruct);
+    void _setDatabase(const QSharedPointer<DATABASE_SNAPSHOT> &pDatabase);  // Publishes a snapshot nobody else holds yet
+    const DATABASE_SNAPSHOT *_holdDatabase();
+    QSharedPointer<const DATABASE_SNAPSHOT> _getDatabase() const;
+    static QString _getSignatureKey(const SIGNATURE_RECORD &record);
+    static void _compareSignatures(const QList<SIGNATURE_RECORD> &listOld, const QList<SIGNATURE_RECORD> &listNew, DATABASE_RELOAD_RESULT *pResult);
+    void _updateDatabaseWatcher();
+    void _loadMetadata(const QString &sDatabasePath, QList<METADATA_RECORD> *pListMetadata, XBinary::PDSTRUCT *pPdStruct);
+    static void _buildLiteralIndex(DATABASE_SNAPSHOT *pDatabase);
+    static void _buildSignatureBuckets(DATABASE_SNAPSHOT *pDatabase);
+    static void _buildMetadataIndex(DATABASE_SNAPSHOT *pDatabase);
+    static QString _getMetadataKey(XBinary::FT fileType, const QString &sName);
+    static bool _isMetadataFile(const QString &sFileName, XBinary::FT *pFileType);
+    static QString _getSignatureInitType(const QString &sText);
+    static QString _getDatabaseFingerprint(const DATABASE_SNAPSHOT *pDatabase);
+    bool loadDatabase(const QString &sDatabasePath, DT databaseType, bool bUseCache, DATABASE_SNAPSHOT *pDatabase, XBinary::PDSTRUCT *pPdStruct = nullptr);
+    static QList<DATABASE_FOLDER> _getDatabaseFolders();
+    QList<DATABASE_FILE> _getDatabaseFiles(const QString &sDatabasePath, XBinary::PDSTRUCT *pPdStruct);
+    QList<SIGNATURE_RECORD> _loadDatabaseFromPath(const QString &sDatabasePath, DT databaseType, qint32 nNumberOfThreads, XBinary::PDSTRUCT *pPdStruct);
+    // false if cancelled, the lists are then left unchanged
+    bool _loadDatabaseFromPathCached(const QString &sDatabasePath, const QString &sCachePath, DT databaseType, bool bUseCache, QList<SIGNATURE_RECORD> *pListRecords,
+                                     QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct);
+    // Also collects the "_metadata" records of the same listing if pListMetadata is set
+    bool _loadDatabaseFromArchive(const QString &sFileName, DT databaseType, qint32 nNumberOfThreads, QList<SIGNATURE_RECORD> *pListRecords,
+                                  QList<METADATA_RECORD> *pListMetadata, XBinary::PDSTRUCT *pPdStruct);
+    // Reads and parses the files on a pool (0 threads = QThread::idealThreadCount()); the result keeps the order of listFiles.
+    // 1 thread, or files of an engine without isDatabaseLoadReentrant(), load sequentially on the calling thread.
+    // pListFileIndexes, if set, gets the index in listFiles of each record
+    QList<SIGNATURE_RECORD> _loadDatabaseFiles(const QString &sArchiveFileName, QList<XArchive::RECORD> *pListArchiveRecords, const QList<DATABASE_FILE> &listFiles,
+                                               DT databaseType, qint32 nNumberOfThreads, QList<qint32> *pListFileIndexes, XBinary::PDSTRUCT *pPdStruct);
+    void _loadDatabaseFilesChunk(const QString &sArchiveFileName, QList<XArchive::RECORD> *pListArchiveRecords, const QList<DATABASE_FILE> &listFiles, DT databaseType,
+                                 qint32 nStart, qint32 nEnd, QList<SIGNATURE_RECORD> *pListRecords, QList<qint32> *pListFileIndexes, XBinary::PDSTRUCT *pPdStruct);
     static QMap<QString, XBinary::FT> _getDatabaseFileTypeMap();
     QList<METADATA_RECORD> _parseMetadata(const QString &sData, XBinary::FT fileType);
     static QString _getDatabaseCachePath(const QString &sDatabasePath);
-    static void _getDatabaseStats(const QString &sDatabasePath, quint32 *pnFileCount, quint64 *pnTotalSize, qint64 *pnNewestMtime);
-    bool _loadDatabaseCache(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, XBinary::PDSTRUCT *pPdStruct);
-    void _saveDatabaseCache(const QString &sCachePath, const QList<SIGNATURE_RECORD> &listRecords, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime);
+    static QString _getDatabaseManifestPath(const QString &sCachePath);
+    // Metadata of an archive database, read on a cache hit instead of listing the archive
+    static QString _getDatabaseMetadataCachePath(const QString &sCachePath);
+    static bool _loadDatabaseMetadataCache(const QString &sFileName, const QString &sEngineName, QList<METADATA_RECORD> *pListMetadata);
+    static void _saveDatabaseMetadataCache(const QString &sFileName, const QString &sEngineName, const QList<METADATA_RECORD> &listMetadata);
+    static QByteArray _getDatabaseFileHash(const QString &sFileName);
+    static bool _loadDatabaseManifest(const QString &sFileName, const QString &sEngineName, DATABASE_MANIFEST *pManifest);
+    static void _saveDatabaseManifest(const QString &sFileName, const QString &sEngineName, const DATABASE_MANIFEST &manifest);
+    bool _loadDatabaseCache(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, QList<SIGNATURE_RECORD> *pListRecords,
+                            QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct);
+    bool _loadDatabaseCacheStream(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, QList<SIGNATURE_RECORD> *pListRecords,
+                                  XBinary::PDSTRUCT *pPdStruct);
+    bool _loadDatabaseCacheMapped(const QString &sCachePath, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime, QList<SIGNATURE_RECORD> *pListRecords,
+                                  QList<QSharedPointer<QFile>> *pListCacheFiles, XBinary::PDSTRUCT *pPdStruct);
+    void _saveDatabaseCache(const QString &sCachePath, const QList<SIGNATURE_RECORD> &listRecords, quint32 nFileCount, quint64 nTotalSize, qint64 nNewestMtime,
+                            quint32 nVersion = 7);
+    // A sub-scan of one file part or archive record dispatched to the pool
+    struct SUBSCAN_TASK {
+        QIODevice *pDevice;  // Owned by the task
+        bool bFileBuffer;    // pDevice is from XBinary::createFileBuffer
+        SCANID scanId;
+        SCAN_OPTIONS options;
+        SCAN_RESULT scanResult;
+        XBinary::PDSTRUCT pdStruct;  // Linked to the parent PDSTRUCT by SUBSCAN_QUEUE::pWatchdog
+        qint32 nWatch;
+        QList<QPair<QtMsgType, QString>> listMessages;  // Engine messages, emitted by the parent thread at merge
+    };
+
+    // Sub-scans of one _scanProcess call, merged in dispatch order
+    struct SUBSCAN_QUEUE {
+        qint32 nNumberOfThreads;
+        QThreadPool *pThreadPool;
+        QList<SUBSCAN_TASK *> listTasks;
+        QList<QFuture<void>> listFutures;
+        qint32 nNumberOfFinished;  // Leading tasks known to be done
+        QList<XScanEngine *> listEngines;
+        QList<XScanEngine *> listFreeEngines;
+        QMutex mutexEngines;
+        XScanWatchdog *pWatchdog;  // SCAN_OPTIONS::pWatchdog if set
+        bool bIsWatchdogOwned;
+    };
+
+    bool _initSubScans(SUBSCAN_QUEUE *pQueue);
+    void _addSubScan(SUBSCAN_QUEUE *pQueue, QIODevice *pDevice, bool bFileBuffer, const SCANID &scanId, const SCAN_OPTIONS &options, XBinary::PDSTRUCT *pPdStruct);
+    void _finishSubScans(SUBSCAN_QUEUE *pQueue, SCAN_RESULT *pScanResult, XBinary::PDSTRUCT *pPdStruct);
+    void _scanProcess(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, bool bInit, XBinary::PDSTRUCT *pPdStruct);
+    void _scanProcessBudget(QIODevice *pDevice, SCAN_RESULT *pScanResult, SCANID parentId, SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pPdStruct);
+    QString _getResultCacheKey(QIODevice *pDevice, SCAN_OPTIONS *pScanOptions);
+    static qint64 _getResultCacheBase(QIODevice *pDevice, XBinary::PDSTRUCT *pPdStruct);
+    static void _rebaseResultCacheRecords(QList<SCANSTRUCT> *pListRecords, qint64 nDelta);
+    // Runs _processDetect and records the pass in SCAN_OPTIONS::pProfiler
+    void _processDetectProfiled(SCANID *pScanID, SCAN_RESULT *pScanResult, QIODevice *pDevice, const SCANID &parentId, XBinary::FT fileType,
+                                SCAN_OPTIONS *pOptions, bool bAddUnknown, XBinary::PDSTRUCT *pPdStruct);
+    // XFormats::getFileTypes, counted in SCAN_OPTIONS::pProfiler
+    static QSet<XBinary::FT> _getFileTypes(QIODevice *pDevice, SCAN_OPTIONS *pOptions, XBinary::PDSTRUCT *pPdStruct);
+    static TEST_CASE_RECORD _testCase(XScanEngine *pEngine, const QString &sDirectoryName, const QJsonObject &jsonTestCase, XBinary::PDSTRUCT *pPdStruct);
+    static QMap<QString, qint64> _loadTestBaseline(const QString &sFileName);
 
 protected:
     virtual void _processDetect(SCANID *pScanID, SCAN_RESULT *pScanResult, QIODevice *pDevice, const SCANID &parentId, XBinary::FT fileType, SCAN_OPTIONS *pOptions,
                                 bool bAddUnknown, XBinary::PDSTRUCT *pPdStruct);
     void _errorMessage(SCAN_OPTIONS *pOptions, const QString &sErrorMessage);
+    // For engines: call when Binary_Script::finishSignature returns true; the result is then not cached
+    void _addSignatureTimeout(SCAN_RESULT *pScanResult, SCAN_OPTIONS *pOptions, const QString &sSignature);
     void _warningMessage(SCAN_OPTIONS *pOptions, const QString &sWarningMessage);
     void _infoMessage(SCAN_OPTIONS *pOptions, const QString &sInfoMessage);
+    // For the signature loop of an engine: bit i is set if getDatabaseSnapshot(pOptions)->listSignatures[i] has to run for this file;
+    // all bits are set if the prefilter is off or verified. The base _processDetect runs no signatures and does not call it
+    QBitArray getSignatureCandidates(Binary_Script *pBinaryScript, SCAN_OPTIONS *pOptions);
+    // For the same loop, after it: warns about each detected signature (indexes into listSignatures) the prefilter would have skipped
+    void _verifyLiteralPrefilter(Binary_Script *pBinaryScript, const QList<qint32> &listDetectedSignatures, SCAN_OPTIONS *pOptions);
 
 signals:
     void errorMessage(const QString &sErrorMessage);
@@ -1422,17 +1673,30 @@ signals:
     void infoMessage(const QString &sInfoMessage);
     void scanFileStarted(const QString &sFileName);
     void scanResult(const XScanEngine::SCAN_RESULT &scanResult);
+    void databaseReloaded(const XScanEngine::DATABASE_RELOAD_RESULT &reloadResult);
 
-protected:
-    QList<SIGNATURE_RECORD> m_listSignatures;
-    QList<METADATA_RECORD> m_listMetadata;
+private slots:
+    void _databaseChangedSlot(const QString &sPath);
+    void _databaseReloadSlot();
 
 private:
+    QSharedPointer<const DATABASE_SNAPSHOT> m_pDatabase;
+    QMutex m_mutexStats;
+    STATS m_stats;
+    QWeakPointer<const DATABASE_SNAPSHOT> m_pStatsDatabase;
+    QSharedPointer<const DATABASE_SNAPSHOT> m_pHeldDatabase;  // Keeps the lists returned by getSignatures() and getMetadata() alive
+    QMutex m_mutexHeldDatabase;
+    mutable QReadWriteLock m_lockDatabase;  // Guards m_pDatabase only, never held across a scan
+    QMutex m_mutexDatabaseReload;
+    DATABASE_WATCH m_databaseWatch;
+    QFileSystemWatcher *m_pDatabaseWatcher;
+    QTimer *m_pDatabaseReloadTimer;
 };
 
 bool sort_signature_prio(const XScanEngine::SIGNATURE_RECORD &sr1, const XScanEngine::SIGNATURE_RECORD &sr2);
 bool sort_signature_name(const XScanEngine::SIGNATURE_RECORD &sr1, const XScanEngine::SIGNATURE_RECORD &sr2);
 
 Q_DECLARE_METATYPE(XScanEngine::SCAN_RESULT)
+Q_DECLARE_METATYPE(XScanEngine::DATABASE_RELOAD_RESULT)
 
 #endif  // XSCANENGINE_H
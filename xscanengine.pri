@@ -3,6 +3,8 @@ DEPENDPATH += $$PWD
 INCLUDEPATH += $$PWD/modules
 DEPENDPATH += $$PWD/modules
 
+QT += concurrent
+
 XCONFIG += use_dex
 XCONFIG += use_pdf
 XCONFIG += use_archive
@@ -12,6 +14,11 @@ HEADERS += \
     $$PWD/scanitemmodel.h \
     $$PWD/xscanengine.h \
     $$PWD/xscanengineprocess.h \
+    $$PWD/xscanliteralindex.h \
+    $$PWD/xscanparsecache.h \
+    $$PWD/xscanprofiler.h \
+    $$PWD/xscanresultcache.h \
+    $$PWD/xscanwatchdog.h \
     $$PWD/modules/amiga_script.h \
     $$PWD/modules/atarist_script.h \
     $$PWD/modules/archive_script.h \
@@ -49,6 +56,11 @@ SOURCES += \
     $$PWD/scanitemmodel.cpp \
     $$PWD/xscanengine.cpp \
     $$PWD/xscanengineprocess.cpp \
+    $$PWD/xscanliteralindex.cpp \
+    $$PWD/xscanparsecache.cpp \
+    $$PWD/xscanprofiler.cpp \
+    $$PWD/xscanresultcache.cpp \
+    $$PWD/xscanwatchdog.cpp \
     $$PWD/modules/amiga_script.cpp \
     $$PWD/modules/atarist_script.cpp \
     $$PWD/modules/archive_script.cpp \
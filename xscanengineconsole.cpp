@@ -21,8 +21,11 @@
 #include "xscanengineconsole.h"
 #include "xconsoloutput.h"
 #include "xarchives.h"
+#include "xscanengineprocess.h"
+#include "xscanresultcache.h"
 
 #include <QDateTime>
+#include <QDirIterator>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QJsonObject>
@@ -1125,6 +1128,36 @@ int XScanEngineConsole::process()
                                          QStringLiteral("password"));
     QCommandLineOption clArchivePasswordStdin(QStringList() << QStringLiteral("password-stdin"),
                                               QStringLiteral("Read the archive password as one UTF-8 line from standard input."));
+    QCommandLineOption clBenchmark(QStringList() << QStringLiteral("benchmark"), QStringLiteral("Run a built-in benchmark: dbcache, dbload, pe <files or directories>, parse <files or directories>."), QStringLiteral("name"));
+    QCommandLineOption clTest(QStringList() << QStringLiteral("test"), QStringLiteral("Run the regression tests described by tests.json in a directory."),
+                              QStringLiteral("directory"));
+    QCommandLineOption clTestThreads(QStringList() << QStringLiteral("test-threads"), QStringLiteral("Number of test cases run in parallel (default: CPU count)."),
+                                     QStringLiteral("number"));
+    QCommandLineOption clTestBaseline(QStringList() << QStringLiteral("test-baseline"),
+                                      QStringLiteral("Flag test cases whose scan time regressed against a baseline file."), QStringLiteral("file"));
+    QCommandLineOption clTestThreshold(QStringList() << QStringLiteral("test-threshold"),
+                                       QStringLiteral("Scan time increase over the baseline counted as a regression (default: 25)."), QStringLiteral("percent"));
+    QCommandLineOption clTestSaveBaseline(QStringList() << QStringLiteral("test-save-baseline"), QStringLiteral("Save the scan times of passed test cases as a baseline."),
+                                          QStringLiteral("file"));
+    QCommandLineOption clResultAsNDJSON(QStringList() << QStringLiteral("ndjson"),
+                                        QStringLiteral("Result as line-delimited JSON: one compact record per file, flushed as soon as the file is scanned."));
+    QCommandLineOption clResultCache(QStringList() << QStringLiteral("result-cache"), QStringLiteral("Reuse scan results of files and members with identical content."));
+    QCommandLineOption clResultCacheDir(QStringList() << QStringLiteral("result-cache-dir"),
+                                        QStringLiteral("Keep reusable scan results in a directory across runs (implies --result-cache)."), QStringLiteral("directory"));
+    QCommandLineOption clProfilingOutput(QStringList() << QStringLiteral("profiling-output"),
+                                         QStringLiteral("Write signature, script API and detection timings to a file (CSV for *.csv, otherwise JSON)."),
+                                         QStringLiteral("file"));
+    QCommandLineOption clFileTimeout(QStringList() << QStringLiteral("file-timeout"),
+                                     QStringLiteral("Stop the scan of a file after this time and report its partial result."), QStringLiteral("ms"));
+    QCommandLineOption clSignatureTimeout(QStringList() << QStringLiteral("signature-timeout"),
+                                          QStringLiteral("Stop the searches and reads of a signature after this time."), QStringLiteral("ms"));
+    QCommandLineOption clThreads(QStringList() << QStringLiteral("threads"),
+                                 QStringLiteral("Number of files of a directory scanned in parallel (default: 1; serial if the engine cannot be cloned)."),
+                                 QStringLiteral("number"));
+    QCommandLineOption clSubScanThreads(
+        QStringList() << QStringLiteral("subscan-threads"),
+        QStringLiteral("Number of archive records, resources and overlays of one file scanned in parallel (default: 1; serial if the engine cannot be cloned)."),
+        QStringLiteral("number"));
 
     QCommandLineOption clFileType = XOptions::getCommandLineOption(XOptions::CONSOLE_OPTION_ID_FILETYPE);
     QCommandLineOption clFirstWrapperOnly = XOptions::getCommandLineOption(XOptions::CONSOLE_OPTION_ID_FIRSTWRAPPERONLY);
@@ -1164,6 +1197,20 @@ int XScanEngineConsole::process()
     parser.addOption(clExtractArchive);
     parser.addOption(clArchivePassword);
     parser.addOption(clArchivePasswordStdin);
+    parser.addOption(clBenchmark);
+    parser.addOption(clTest);
+    parser.addOption(clTestThreads);
+    parser.addOption(clTestBaseline);
+    parser.addOption(clTestThreshold);
+    parser.addOption(clTestSaveBaseline);
+    parser.addOption(clProfilingOutput);
+    parser.addOption(clResultAsNDJSON);
+    parser.addOption(clResultCache);
+    parser.addOption(clResultCacheDir);
+    parser.addOption(clFileTimeout);
+    parser.addOption(clSignatureTimeout);
+    parser.addOption(clThreads);
+    parser.addOption(clSubScanThreads);
     parser.addOption(clNoColor);
 
     addEngineOptions(&parser);
@@ -1178,12 +1225,19 @@ int XScanEngineConsole::process()
     nNumberOfResultFormats += parser.isSet(clResultAsCSV);
     nNumberOfResultFormats += parser.isSet(clResultAsTSV);
     nNumberOfResultFormats += parser.isSet(clResultAsPlainText);
+    nNumberOfResultFormats += parser.isSet(clResultAsNDJSON);
 
     if (nNumberOfResultFormats > 1) {
         printf("Error: select only one result format\n");
         return XOptions::CR_INVALIDPARAMETER;
     }
 
+    // One JSON record per file; entropy, file info and struct output have no place in it
+    if (parser.isSet(clResultAsNDJSON) && (parser.isSet(clEntropy) || parser.isSet(clInfo) || parser.isSet(clStruct))) {
+        printf("Error: --ndjson cannot be combined with --entropy, --info or --struct\n");
+        return XOptions::CR_INVALIDPARAMETER;
+    }
+
     XScanEngine::SCAN_OPTIONS scanOptions = {};
 
     scanOptions.bUseCustomDatabase = (engineType == XScanEngine::SCANENGINETYPE_DIE);
@@ -1203,6 +1257,38 @@ int XScanEngineConsole::process()
     scanOptions.bIsFirstWrapperScan = parser.isSet(clFirstWrapperOnly);
     scanOptions.bHideUnknown = parser.isSet(clHideUnknown);
     scanOptions.bLogProfiling = parser.isSet(clProfiling);
+
+    XScanProfiler profiler;
+
+    if (parser.isSet(clProfilingOutput)) {
+        scanOptions.pProfiler = &profiler;
+    }
+
+    XScanResultCache resultCache;
+
+    if (parser.isSet(clResultCacheDir)) {
+        resultCache.setDirectory(parser.value(clResultCacheDir));
+    }
+
+    if (parser.isSet(clResultCache) || parser.isSet(clResultCacheDir)) {
+        scanOptions.pResultCache = &resultCache;
+    }
+
+    if (parser.isSet(clFileTimeout)) {
+        scanOptions.nFileTimeout = parser.value(clFileTimeout).toInt();
+    }
+
+    if (parser.isSet(clSignatureTimeout)) {
+        scanOptions.nSignatureTimeout = parser.value(clSignatureTimeout).toInt();
+    }
+
+    if (parser.isSet(clThreads)) {
+        scanOptions.nNumberOfThreads = parser.value(clThreads).toInt();
+    }
+
+    if (parser.isSet(clSubScanThreads)) {
+        scanOptions.nNumberOfSubScanThreads = parser.value(clSubScanThreads).toInt();
+    }
     scanOptions.bShowEntropy = parser.isSet(clEntropy);
     scanOptions.bShowFileInfo = parser.isSet(clInfo);
     scanOptions.bResultAsXML = parser.isSet(clResultAsXml);
@@ -1210,6 +1296,7 @@ int XScanEngineConsole::process()
     scanOptions.bResultAsCSV = parser.isSet(clResultAsCSV);
     scanOptions.bResultAsTSV = parser.isSet(clResultAsTSV);
     scanOptions.bResultAsPlainText = parser.isSet(clResultAsPlainText);
+    scanOptions.bResultAsNDJSON = parser.isSet(clResultAsNDJSON);
     scanOptions.bIsSort = true;
     scanOptions.fileType = parser.isSet(clFileType) ? XBinary::ftStringToFileTypeId(parser.value(clFileType)) : XBinary::FT_UNKNOWN;
 
@@ -1274,9 +1361,16 @@ int XScanEngineConsole::process()
     XConsoleOutput consoleOutput;
 
     if (parser.isSet(clMessages)) {
-        QObject::connect(&m_scanEngine, SIGNAL(errorMessage(QString)), &consoleOutput, SLOT(errorMessage(QString)));
-        QObject::connect(&m_scanEngine, SIGNAL(warningMessage(QString)), &consoleOutput, SLOT(warningMessage(QString)));
-        QObject::connect(&m_scanEngine, SIGNAL(infoMessage(QString)), &consoleOutput, SLOT(infoMessage(QString)));
+        if (scanOptions.bResultAsNDJSON) {
+            // stdout is the NDJSON stream, messages go to stderr
+            QObject::connect(&m_scanEngine, &XScanEngine::errorMessage, [](const QString &sText) { fprintf(stderr, "%s\n", sText.toUtf8().constData()); });
+            QObject::connect(&m_scanEngine, &XScanEngine::warningMessage, [](const QString &sText) { fprintf(stderr, "%s\n", sText.toUtf8().constData()); });
+            QObject::connect(&m_scanEngine, &XScanEngine::infoMessage, [](const QString &sText) { fprintf(stderr, "%s\n", sText.toUtf8().constData()); });
+        } else {
+            QObject::connect(&m_scanEngine, SIGNAL(errorMessage(QString)), &consoleOutput, SLOT(errorMessage(QString)));
+            QObject::connect(&m_scanEngine, SIGNAL(warningMessage(QString)), &consoleOutput, SLOT(warningMessage(QString)));
+            QObject::connect(&m_scanEngine, SIGNAL(infoMessage(QString)), &consoleOutput, SLOT(infoMessage(QString)));
+        }
     }
 
     bool bIsDbUsed = false;
@@ -1298,6 +1392,79 @@ int XScanEngineConsole::process()
         bProcessed = true;
     }
 
+    if (parser.isSet(clBenchmark)) {
+        QString sBenchmark = parser.value(clBenchmark);
+
+        if (!bIsDbUsed) {
+            bDbLoaded = m_scanEngine.loadDatabase(&scanOptions, &pdStruct);
+            bIsDbUsed = true;
+        }
+
+        if (sBenchmark == "dbcache") {
+            printf("%s", XScanEngine::benchmarkToString(m_scanEngine.benchmarkDatabaseCache(20, &pdStruct)).toUtf8().data());
+        } else if (sBenchmark == "dbload") {
+            printf("%s", XScanEngine::benchmarkToString(m_scanEngine.benchmarkDatabaseLoad(scanOptions.sMainDatabasePath, 5, &pdStruct)).toUtf8().data());
+        } else if ((sBenchmark == "pe") || (sBenchmark == "parse")) {
+            QList<QString> listFileNames;
+
+            for (const QString &sFileName : listArgs) {
+                if (QFileInfo(sFileName).isDir()) {
+                    XBinary::findFiles(sFileName, &listFileNames, true, 0, &pdStruct);
+                } else {
+                    listFileNames.append(sFileName);
+                }
+            }
+
+            if (sBenchmark == "pe") {
+                printf("%s", XScanEngine::benchmarkToString(XScanEngine::benchmarkPEScript(listFileNames, 5, &pdStruct)).toUtf8().data());
+            } else {
+                printf("%s", XScanEngine::benchmarkToString(XScanEngine::benchmarkParseCache(listFileNames, 5, &pdStruct)).toUtf8().data());
+            }
+        } else {
+            printf("Error: unknown benchmark: %s\n", sBenchmark.toUtf8().data());
+            nResult = XOptions::CR_INVALIDPARAMETER;
+        }
+
+        bProcessed = true;
+    }
+
+    if (parser.isSet(clTest)) {
+        if (!bIsDbUsed) {
+            bDbLoaded = m_scanEngine.loadDatabase(&scanOptions, &pdStruct);
+            bIsDbUsed = true;
+        }
+
+        XScanEngine::TEST_OPTIONS testOptions = XScanEngine::getDefaultTestOptions();
+
+        if (parser.isSet(clTestThreads)) {
+            testOptions.nNumberOfThreads = parser.value(clTestThreads).toInt();
+        }
+
+        if (parser.isSet(clTestThreshold)) {
+            testOptions.nRegressionPercent = parser.value(clTestThreshold).toInt();
+        }
+
+        testOptions.sBaselineFileName = parser.value(clTestBaseline);
+
+        XScanEngine::TEST_RESULT testResult = m_scanEngine.test(parser.value(clTest), &testOptions, &pdStruct);
+
+        printf("%s", XScanEngine::testResultToString(testResult).toUtf8().data());
+
+        if (parser.isSet(clTestSaveBaseline)) {
+            if (!XScanEngine::saveTestBaseline(parser.value(clTestSaveBaseline), testResult)) {
+                printf("Cannot save: %s\n", parser.value(clTestSaveBaseline).toUtf8().data());
+                nResult = XOptions::CR_CANNOTOPENFILE;
+            }
+        }
+
+        // Non-zero exit code for CI when a case failed or got slower
+        if (testResult.nErrors || testResult.nRegressions) {
+            nResult = XOptions::CR_INVALIDPARAMETER;
+        }
+
+        bProcessed = true;
+    }
+
     if (parser.isSet(clListArchive)) {
         if (!listArgs.isEmpty()) {
             bool bShowFileName = (listArgs.count() > 1);
@@ -1552,6 +1719,12 @@ int XScanEngineConsole::process()
 
         if ((!bNeedDatabase) || bDbLoaded) {
             nResult = handleFiles(listArgs, &scanOptions, m_scanEngine, &pdStruct);
+
+            if (scanOptions.pProfiler) {
+                if (!profiler.save(parser.value(clProfilingOutput))) {
+                    printf("Cannot save: %s\n", parser.value(clProfilingOutput).toUtf8().data());
+                }
+            }
         } else {
             printf("Cannot load database: %s\n", scanOptions.sMainDatabasePath.toUtf8().data());
         }
@@ -1573,12 +1746,24 @@ int XScanEngineConsole::process()
 
 XOptions::CR XScanEngineConsole::handleFiles(const QStringList &listArgs, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine, XBinary::PDSTRUCT *pPdStruct)
 {
+    if (pScanOptions->bResultAsNDJSON && (!pScanOptions->bShowEntropy) && (!pScanOptions->bShowFileInfo) && (pScanOptions->sStruct == "")) {
+        return handleFilesNDJSON(listArgs, pScanOptions, scanEngine, pPdStruct);
+    }
+
     XOptions::CR result = XOptions::CR_SUCCESS;
 
+    bool bParallel = (pScanOptions->nNumberOfThreads > 1) && (!pScanOptions->bShowEntropy) && (!pScanOptions->bShowFileInfo) && (pScanOptions->sStruct == "");
+
     QStringList listFileNames;
 
     for (const QString &sFileName : listArgs) {
-        if (QFileInfo::exists(sFileName)) {
+        if (bParallel && QFileInfo(sFileName).isDir()) {
+            XOptions::CR crDirectory = _scanDirectoryParallel(sFileName, pScanOptions, scanEngine, false, pPdStruct);
+
+            if (crDirectory != XOptions::CR_SUCCESS) {
+                result = crDirectory;
+            }
+        } else if (QFileInfo::exists(sFileName)) {
             XBinary::findFiles(sFileName, &listFileNames, pPdStruct);
         } else {
             printf("Cannot find: %s\n", sFileName.toUtf8().data());
@@ -1587,7 +1772,7 @@ XOptions::CR XScanEngineConsole::handleFiles(const QStringList &listArgs, XScanE
         }
     }
 
-    bool bShowFileName = listFileNames.count() > 1;
+    bool bShowFileName = bParallel || (listFileNames.count() > 1);
 
     qint32 nNumberOfFiles = listFileNames.count();
 
@@ -1619,32 +1804,175 @@ XOptions::CR XScanEngineConsole::handleFiles(const QStringList &listArgs, XScanE
         } else {
             XScanEngine::SCAN_RESULT scanResult = scanEngine.scanFile(sFileName, pScanOptions, pPdStruct);
 
-            ScanItemModel model(pScanOptions, &(scanResult.listRecords), 1, nullptr);
+            XOptions::CR crFile = _printScanResult(&scanResult, pScanOptions);
 
-            XBinary::FORMATTYPE formatType = XBinary::FORMATTYPE_TEXT;
+            if (crFile != XOptions::CR_SUCCESS) {
+                result = crFile;
+            }
+        }
+    }
+
+    return result;
+}
+
+XOptions::CR XScanEngineConsole::_printScanResult(XScanEngine::SCAN_RESULT *pScanResult, XScanEngine::SCAN_OPTIONS *pScanOptions)
+{
+    XOptions::CR result = XOptions::CR_SUCCESS;
+
+    ScanItemModel model(pScanOptions, &(pScanResult->listRecords), 1, nullptr);
+
+    XBinary::FORMATTYPE formatType = XBinary::FORMATTYPE_TEXT;
 
-            if (pScanOptions->bResultAsCSV) formatType = XBinary::FORMATTYPE_CSV;
-            else if (pScanOptions->bResultAsJSON) formatType = XBinary::FORMATTYPE_JSON;
-            else if (pScanOptions->bResultAsTSV) formatType = XBinary::FORMATTYPE_TSV;
-            else if (pScanOptions->bResultAsXML) formatType = XBinary::FORMATTYPE_XML;
-            else if (pScanOptions->bResultAsPlainText) formatType = XBinary::FORMATTYPE_PLAINTEXT;
+    if (pScanOptions->bResultAsCSV) formatType = XBinary::FORMATTYPE_CSV;
+    else if (pScanOptions->bResultAsJSON) formatType = XBinary::FORMATTYPE_JSON;
+    else if (pScanOptions->bResultAsTSV) formatType = XBinary::FORMATTYPE_TSV;
+    else if (pScanOptions->bResultAsXML) formatType = XBinary::FORMATTYPE_XML;
+    else if (pScanOptions->bResultAsPlainText) formatType = XBinary::FORMATTYPE_PLAINTEXT;
 
-            if (formatType != XBinary::FORMATTYPE_TEXT) {
-                printf("%s\n", model.toString(formatType).toUtf8().data());
+    if (formatType != XBinary::FORMATTYPE_TEXT) {
+        printf("%s\n", model.toString(formatType).toUtf8().data());
+    } else {
+        model.coloredOutput();
+    }
+
+    if (pScanResult->listErrors.count()) {
+        result = reportScanErrors(pScanResult);
+    }
+    printf("\n");
+
+    return result;
+}
+
+XOptions::CR XScanEngineConsole::_scanDirectoryParallel(const QString &sDirectoryName, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine,
+                                                        bool bNDJSON, XBinary::PDSTRUCT *pPdStruct)
+{
+    XOptions::CR result = XOptions::CR_SUCCESS;
+
+    XScanEngine::SCAN_OPTIONS scanOptions = *pScanOptions;
+    scanOptions.bSubdirectories = true;
+
+    XScanEngineProcess scanEngineProcess(&scanEngine);
+
+    // The results are emitted on this thread, in file order
+    connect(
+        &scanEngineProcess, &XScanEngineProcess::scanResult, this,
+        [&](const XScanEngine::SCAN_RESULT &scanResult) {
+            XScanEngine::SCAN_RESULT _scanResult = scanResult;
+
+            XOptions::CR crFile = XOptions::CR_SUCCESS;
+
+            if (bNDJSON) {
+                crFile = _printResultNDJSON(&_scanResult, &scanOptions);
             } else {
-                model.coloredOutput();
+                printf("%s:\n", QDir().toNativeSeparators(_scanResult.sFileName).toUtf8().data());
+
+                crFile = _printScanResult(&_scanResult, &scanOptions);
+            }
+
+            if (crFile != XOptions::CR_SUCCESS) {
+                result = crFile;
+            }
+        },
+        Qt::DirectConnection);
+
+    scanEngineProcess.setData(sDirectoryName, &scanOptions, pPdStruct);
+    scanEngineProcess.process();
+
+    return result;
+}
+
+XOptions::CR XScanEngineConsole::handleFilesNDJSON(const QStringList &listArgs, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine,
+                                                   XBinary::PDSTRUCT *pPdStruct)
+{
+    XOptions::CR result = XOptions::CR_SUCCESS;
+
+    // Directories are walked lazily and nothing is kept per file, so memory does not grow with the corpus
+    for (const QString &sArg : listArgs) {
+        if (!XBinary::isPdStructNotCanceled(pPdStruct)) {
+            break;
+        }
+
+        QFileInfo fileInfo(sArg);
+
+        if (fileInfo.isDir() && (pScanOptions->nNumberOfThreads > 1)) {
+            XOptions::CR crDirectory = _scanDirectoryParallel(sArg, pScanOptions, scanEngine, true, pPdStruct);
+
+            if (crDirectory != XOptions::CR_SUCCESS) {
+                result = crDirectory;
             }
+        } else if (fileInfo.isDir()) {
+            QDirIterator it(sArg, QDir::Files | QDir::Hidden | QDir::System, QDirIterator::Subdirectories);
 
-            if (scanResult.listErrors.count()) {
-                XOptions::CR crErrors = reportScanErrors(&scanResult);
+            while (it.hasNext() && XBinary::isPdStructNotCanceled(pPdStruct)) {
+                XOptions::CR crFile = _scanFileNDJSON(it.next(), pScanOptions, scanEngine, pPdStruct);
 
-                if (crErrors != XOptions::CR_SUCCESS) {
-                    result = crErrors;
+                if (crFile != XOptions::CR_SUCCESS) {
+                    result = crFile;
                 }
             }
-            printf("\n");
+        } else if (fileInfo.exists()) {
+            XOptions::CR crFile = _scanFileNDJSON(sArg, pScanOptions, scanEngine, pPdStruct);
+
+            if (crFile != XOptions::CR_SUCCESS) {
+                result = crFile;
+            }
+        } else {
+            QJsonObject jsRecord;
+            jsRecord.insert("filename", QDir().toNativeSeparators(sArg));
+            jsRecord.insert("error", QString("Cannot find"));
+
+            printf("%s\n", QJsonDocument(jsRecord).toJson(QJsonDocument::Compact).constData());
+            fflush(stdout);
+
+            result = XOptions::CR_CANNOTFINDFILE;
         }
     }
 
     return result;
 }
+
+XOptions::CR XScanEngineConsole::_scanFileNDJSON(const QString &sFileName, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine,
+                                                 XBinary::PDSTRUCT *pPdStruct)
+{
+    XScanEngine::SCAN_RESULT scanResult = scanEngine.scanFile(sFileName, pScanOptions, pPdStruct);
+    scanResult.sFileName = sFileName;
+
+    return _printResultNDJSON(&scanResult, pScanOptions);
+}
+
+XOptions::CR XScanEngineConsole::_printResultNDJSON(XScanEngine::SCAN_RESULT *pScanResult, XScanEngine::SCAN_OPTIONS *pScanOptions)
+{
+    XOptions::CR result = XOptions::CR_SUCCESS;
+
+    ScanItemModel model(pScanOptions, &(pScanResult->listRecords), 1, nullptr);
+
+    QJsonObject jsRecord = model.toJsonObject();
+    jsRecord.insert("filename", QDir().toNativeSeparators(pScanResult->sFileName));
+    jsRecord.insert("size", pScanResult->nSize);
+    jsRecord.insert("scantime", pScanResult->nScanTime);
+
+    // Script errors travel in the record; reportScanErrors would print them and break the one-line-per-file stream,
+    // so the file gets the code of its default implementation
+    qint32 nNumberOfErrors = pScanResult->listErrors.count();
+
+    if (nNumberOfErrors) {
+        QJsonArray jsErrors;
+
+        for (qint32 i = 0; i < nNumberOfErrors; i++) {
+            QJsonObject jsError;
+            jsError.insert("script", pScanResult->listErrors.at(i).sScript);
+            jsError.insert("error", pScanResult->listErrors.at(i).sErrorString);
+
+            jsErrors.append(jsError);
+        }
+
+        jsRecord.insert("errors", jsErrors);
+
+        result = XOptions::CR_CANNOTOPENFILE;
+    }
+
+    printf("%s\n", QJsonDocument(jsRecord).toJson(QJsonDocument::Compact).constData());
+    fflush(stdout);
+
+    return result;
+}
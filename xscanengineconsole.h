@@ -41,6 +41,7 @@ public:
 public slots:
     int process();
     XOptions::CR handleFiles(const QStringList &listArgs, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine, XBinary::PDSTRUCT *pPdStruct);
+    XOptions::CR handleFilesNDJSON(const QStringList &listArgs, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine, XBinary::PDSTRUCT *pPdStruct);
 
 protected:
     // Engine-specific extension points. The default implementations below use
@@ -64,6 +65,13 @@ protected:
     XScanEngine *scanEngine();
 
 private:
+    XOptions::CR _scanFileNDJSON(const QString &sFileName, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine, XBinary::PDSTRUCT *pPdStruct);
+    XOptions::CR _printResultNDJSON(XScanEngine::SCAN_RESULT *pScanResult, XScanEngine::SCAN_OPTIONS *pScanOptions);
+    XOptions::CR _printScanResult(XScanEngine::SCAN_RESULT *pScanResult, XScanEngine::SCAN_OPTIONS *pScanOptions);
+    // Scans the files of the directory on SCAN_OPTIONS::nNumberOfThreads engine clones, printing the results in file order
+    XOptions::CR _scanDirectoryParallel(const QString &sDirectoryName, XScanEngine::SCAN_OPTIONS *pScanOptions, XScanEngine &scanEngine, bool bNDJSON,
+                                        XBinary::PDSTRUCT *pPdStruct);
+
     QCoreApplication &m_app;
     XScanEngine &m_scanEngine;
     QString m_sDescription;
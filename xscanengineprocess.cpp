@@ -23,7 +23,10 @@
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
+#include <QMutex>
 #include <QSettings>
+#include <QThreadPool>
+#include <QtConcurrent>
 
 namespace {
 const char *g_pszCollectionProgressFileName = "scan.ini";
@@ -257,30 +260,38 @@ void XScanEngineProcess::process()
 
                 XBinary::setPdStructTotal(pPdStruct, nFreeIndex, nTotal);
 
-                for (qint32 i = nStartIndex; (i < nTotal) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
-                    QString sFileName = listFileNames.at(i);
+                bool bParallel = false;
 
-                    XBinary::setPdStructCurrent(pPdStruct, nFreeIndex, i);
-                    XBinary::setPdStructStatus(pPdStruct, nFreeIndex, sFileName);
+                if (m_pScanOptions->nNumberOfThreads > 1) {
+                    bParallel = _processDirectoryParallel(listFileNames, nStartIndex, sCollectionProgressFileName, nFreeIndex, pPdStruct);
+                }
 
-                    writeCollectionProgress(sCollectionProgressFileName, m_sDirectoryName, sFileName, false);
+                if (!bParallel) {
+                    for (qint32 i = nStartIndex; (i < nTotal) && XBinary::isPdStructNotCanceled(pPdStruct); i++) {
+                        QString sFileName = listFileNames.at(i);
 
-                    emit scanFileStarted(sFileName);
+                        XBinary::setPdStructCurrent(pPdStruct, nFreeIndex, i);
+                        XBinary::setPdStructStatus(pPdStruct, nFreeIndex, sFileName);
 
-                    if (sFileName != "") {
-                        QFile file;
-                        file.setFileName(sFileName);
+                        writeCollectionProgress(sCollectionProgressFileName, m_sDirectoryName, sFileName, false);
 
-                        XScanEngine::SCAN_RESULT scanResult = {};
+                        emit scanFileStarted(sFileName);
 
-                        if (file.open(QIODevice::ReadOnly)) {
-                            scanResult = _scanDevice(&file, m_pScanOptions, pPdStruct);
+                        if (sFileName != "") {
+                            QFile file;
+                            file.setFileName(sFileName);
 
-                            file.close();
-                        }
+                            XScanEngine::SCAN_RESULT scanResult = {};
+
+                            if (file.open(QIODevice::ReadOnly)) {
+                                scanResult = _scanDevice(&file, m_pScanOptions, pPdStruct);
+
+                                file.close();
+                            }
 
-                        XHandler xhandler;
-                        xhandler.processRecords(&scanResult.listHandlers, pPdStruct);
+                            XHandler xhandler;
+                            xhandler.processRecords(&scanResult.listHandlers, pPdStruct);
+                        }
                     }
                 }
 
@@ -298,8 +309,20 @@ void XScanEngineProcess::process()
 
 XScanEngine::SCAN_RESULT XScanEngineProcess::_scanDevice(QIODevice *pDevice, XScanEngine::SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pPdStruct)
 {
-    XScanEngine::SCAN_RESULT _scanResult = m_pScanEngine->scanDevice(pDevice, m_pScanOptions, pPdStruct);
-    emit scanResult(_scanResult);
+    return _scanDevice(pDevice, m_pScanEngine, pScanOptions, nullptr, pPdStruct);
+}
+
+XScanEngine::SCAN_RESULT XScanEngineProcess::_scanDevice(QIODevice *pDevice, XScanEngine *pScanEngine, XScanEngine::SCAN_OPTIONS *pScanOptions,
+                                                         QList<XScanEngine::SCAN_RESULT> *pListResults, XBinary::PDSTRUCT *pPdStruct)
+{
+    XScanEngine::SCAN_RESULT _scanResult = pScanEngine->scanDevice(pDevice, pScanOptions, pPdStruct);
+
+    // Workers collect results and let the owning thread emit them in file order
+    if (pListResults) {
+        pListResults->append(_scanResult);
+    } else {
+        emit scanResult(_scanResult);
+    }
 
     if (!(pDevice->property("IsArchiveRecord").toBool())) {
         if (pScanOptions->bCollectionCopyRemove) {
@@ -309,10 +332,10 @@ XScanEngine::SCAN_RESULT XScanEngineProcess::_scanDevice(QIODevice *pDevice, XSc
         }
     }
 
-    if (m_pScanOptions->bCollection) {
+    if (pScanOptions->bCollection) {
         QSet<XBinary::FT> stFT = XFormats::getFileTypes(pDevice, XBinary::FT_FLAG_FORMATS, pPdStruct);
 
-        if (m_pScanOptions->bIsArchivesScan) {
+        if (pScanOptions->bIsArchivesScan) {
             bool bScanableArchive = false;
 
             if (stFT.contains(XBinary::FT_ZIP) || stFT.contains(XBinary::FT_7Z) || stFT.contains(XBinary::FT_RAR) || stFT.contains(XBinary::FT_CAB) ||
@@ -352,7 +375,7 @@ XScanEngine::SCAN_RESULT XScanEngineProcess::_scanDevice(QIODevice *pDevice, XSc
                                     pArchiveRecord->setProperty("FileName", XBinary::getDeviceDirectory(pDevice) + QDir::separator() +
                                                                                 XBinary::getDeviceFileBaseName(pDevice) + "_ARCHIVE_RECORD_" + sOriginalName);
 
-                                    _scanDevice(pArchiveRecord, pScanOptions, pPdStruct);
+                                    _scanDevice(pArchiveRecord, pScanEngine, pScanOptions, pListResults, pPdStruct);
 
                                     nCurrentIndex++;
                                 } else {
@@ -392,3 +415,139 @@ XScanEngine::SCAN_RESULT XScanEngineProcess::_scanDevice(QIODevice *pDevice, XSc
 
     return _scanResult;
 }
+
+bool XScanEngineProcess::_processDirectoryParallel(const QList<QString> &listFileNames, qint32 nStartIndex, const QString &sCollectionProgressFileName,
+                                                   qint32 nFreeIndex, XBinary::PDSTRUCT *pPdStruct)
+{
+    qint32 nTotal = listFileNames.count();
+    qint32 nNumberOfThreads = m_pScanOptions->nNumberOfThreads;
+
+    // One engine per worker; the signature list is shared (implicitly or by the engine itself)
+    QList<XScanEngine *> listEngines;
+    QList<XScanEngine *> listFreeEngines;
+    QMutex mutexEngines;
+
+    for (qint32 i = 0; i < nNumberOfThreads; i++) {
+        XScanEngine *pEngine = m_pScanEngine->clone();
+
+        if (!pEngine) {
+            break;
+        }
+
+        connect(pEngine, SIGNAL(errorMessage(QString)), this, SIGNAL(errorMessage(QString)));
+        connect(pEngine, SIGNAL(warningMessage(QString)), this, SIGNAL(warningMessage(QString)));
+        connect(pEngine, SIGNAL(infoMessage(QString)), this, SIGNAL(infoMessage(QString)));
+
+        listEngines.append(pEngine);
+        listFreeEngines.append(pEngine);
+    }
+
+    // Without a clone per worker one engine would be driven from several threads
+    if (listEngines.isEmpty()) {
+        return false;
+    }
+
+    nNumberOfThreads = listEngines.count();
+
+    QThreadPool threadPool;
+    threadPool.setMaxThreadCount(nNumberOfThreads);
+
+    // Bounded window: results are drained strictly in file order, so memory does not grow with the corpus
+    qint32 nMaxInFlight = nNumberOfThreads * 2;
+    QList<WORKER_TASK *> listTasks;
+    QList<QFuture<void>> listFutures;
+
+    qint32 nNextIndex = nStartIndex;
+    qint32 nCurrentIndex = nStartIndex;
+
+    while ((nCurrentIndex < nTotal) || (!listTasks.isEmpty())) {
+        bool bCanceled = !XBinary::isPdStructNotCanceled(pPdStruct);
+
+        if (bCanceled) {
+            for (qint32 i = 0; i < listTasks.count(); i++) {
+                listTasks.at(i)->pdStruct.bIsStop = true;
+            }
+        }
+
+        if ((!bCanceled) && (nNextIndex < nTotal) && (listTasks.count() < nMaxInFlight)) {
+            WORKER_TASK *pTask = new WORKER_TASK;
+            pTask->sFileName = listFileNames.at(nNextIndex);
+            pTask->pdStruct = XBinary::createPdStruct();
+            pTask->scanResult = {};
+
+            listTasks.append(pTask);
+            listFutures.append(QtConcurrent::run(&threadPool, [this, pTask, &listFreeEngines, &mutexEngines]() {
+                // The pool runs at most one task per engine
+                mutexEngines.lock();
+                XScanEngine *pEngine = listFreeEngines.takeLast();
+                mutexEngines.unlock();
+
+                if (pTask->sFileName != "") {
+                    QFile file;
+                    file.setFileName(pTask->sFileName);
+
+                    if (file.open(QIODevice::ReadOnly)) {
+                        pTask->scanResult = _scanDevice(&file, pEngine, m_pScanOptions, &(pTask->listResults), &(pTask->pdStruct));
+
+                        file.close();
+                    }
+                }
+
+                mutexEngines.lock();
+                listFreeEngines.append(pEngine);
+                mutexEngines.unlock();
+            }));
+
+            nNextIndex++;
+
+            continue;
+        }
+
+        if (listTasks.isEmpty()) {
+            break;
+        }
+
+        // The oldest file is where a collection scan resumes, so it is the one written to the progress file
+        WORKER_TASK *pTask = listTasks.first();
+
+        XBinary::setPdStructCurrent(pPdStruct, nFreeIndex, nCurrentIndex);
+        XBinary::setPdStructStatus(pPdStruct, nFreeIndex, pTask->sFileName);
+
+        writeCollectionProgress(sCollectionProgressFileName, m_sDirectoryName, pTask->sFileName, false);
+
+        listFutures.first().waitForFinished();
+
+        emit scanFileStarted(pTask->sFileName);
+
+        qint32 nNumberOfResults = pTask->listResults.count();
+
+        for (qint32 i = 0; i < nNumberOfResults; i++) {
+            emit scanResult(pTask->listResults.at(i));
+        }
+
+        if ((!bCanceled) && (pTask->sFileName != "")) {
+            XHandler xhandler;
+            xhandler.processRecords(&(pTask->scanResult.listHandlers), pPdStruct);
+        }
+
+        listTasks.removeFirst();
+        listFutures.removeFirst();
+        delete pTask;
+
+        nCurrentIndex++;
+
+        if (bCanceled && listTasks.isEmpty()) {
+            break;
+        }
+    }
+
+    threadPool.waitForDone();
+
+    qint32 nNumberOfEngines = listEngines.count();
+
+    for (qint32 i = 0; i < nNumberOfEngines; i++) {
+        delete listEngines.at(i);
+    }
+
+    return true;
+}
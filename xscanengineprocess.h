@@ -48,7 +48,19 @@ public:
     virtual void process() override;
 
 private:
+    struct WORKER_TASK {
+        QString sFileName;
+        XBinary::PDSTRUCT pdStruct;
+        XScanEngine::SCAN_RESULT scanResult;
+        QList<XScanEngine::SCAN_RESULT> listResults;  // Main file and collected archive records, in scan order
+    };
+
     XScanEngine::SCAN_RESULT _scanDevice(QIODevice *pDevice, XScanEngine::SCAN_OPTIONS *pScanOptions, XBinary::PDSTRUCT *pPdStruct);
+    XScanEngine::SCAN_RESULT _scanDevice(QIODevice *pDevice, XScanEngine *pScanEngine, XScanEngine::SCAN_OPTIONS *pScanOptions,
+                                         QList<XScanEngine::SCAN_RESULT> *pListResults, XBinary::PDSTRUCT *pPdStruct);
+    // false if the engine cannot be cloned; nothing was scanned and the caller scans serially
+    bool _processDirectoryParallel(const QList<QString> &listFileNames, qint32 nStartIndex, const QString &sCollectionProgressFileName, qint32 nFreeIndex,
+                                   XBinary::PDSTRUCT *pPdStruct);
 
 signals:
     void scanFileStarted(const QString &sFileName);
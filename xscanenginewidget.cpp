@@ -21,10 +21,15 @@
 #include "xscanenginewidget.h"
 #include "ui_xscanenginewidget.h"
 
+#include <QThread>
+
 XScanEngineWidget::XScanEngineWidget(QWidget *pParent) : XShortcutsWidget(pParent), ui(new Ui::XScanEngineWidget)
 {
     ui->setupUi(this);
 
+    // Engines that cannot be cloned scan serially whatever the value
+    ui->spinBoxSubScanThreads->setValue(QThread::idealThreadCount());
+
     m_pScanEngine = nullptr;
     m_pModel = nullptr;
     m_fileType = XBinary::FT_UNKNOWN;
@@ -36,6 +41,7 @@ XScanEngineWidget::XScanEngineWidget(QWidget *pParent) : XShortcutsWidget(pParen
     ui->treeViewResult->setToolTip(tr("Result"));
     ui->comboBoxFlags->setToolTip(tr("Flags"));
     ui->comboBoxDatabases->setToolTip(tr("Database"));
+    ui->spinBoxSubScanThreads->setToolTip(tr("Threads for the archive records, resources and overlay"));
     ui->pushButtonScanStart->setToolTip(tr("Scan"));
     ui->pushButtonScanDirectory->setToolTip(tr("Scan directory"));
     ui->pushButtonCollection->setToolTip(tr("Collection"));
@@ -208,6 +214,7 @@ void XScanEngineWidget::process()
     m_scanOptions.bShowScanTime = true;
     m_scanOptions.bHideUnknown = getGlobalOptions()->getValue(XOptions::ID_SCAN_HIDEUNKNOWN).toBool();
     m_scanOptions.bIsSort = getGlobalOptions()->getValue(XOptions::ID_SCAN_SORT).toBool();
+    m_scanOptions.nNumberOfSubScanThreads = ui->spinBoxSubScanThreads->value();
 
     quint64 nFlags = ui->comboBoxFlags->getValue().toULongLong();
     XScanEngine::setScanFlags(&m_scanOptions, nFlags);
@@ -0,0 +1,442 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xscanliteralindex.h"
+
+#include <QQueue>
+#include <QRegularExpression>
+#include <QSet>
+
+static bool isHexDigit(QChar cChar)
+{
+    return ((cChar >= '0') && (cChar <= '9')) || ((cChar >= 'A') && (cChar <= 'F')) || ((cChar >= 'a') && (cChar <= 'f'));
+}
+
+// One or more X.compare*("...", nOffset) calls joined by &&; strings are already replaced by ""
+static bool isCompareCondition(const QString &sCondition)
+{
+    QString sCall = "[A-Za-z_]\\w*\\s*\\.\\s*(?:compareOverlay|compareEP|compare|c)\\s*\\(\\s*\"\"\\s*(?:,\\s*(?:0x[0-9A-Fa-f]+|\\d+)\\s*)?\\)";
+    QRegularExpression rxCondition(QString("^\\s*%1(?:\\s*&&\\s*%1)*\\s*$").arg(sCall));
+
+    return rxCondition.match(sCondition).hasMatch();
+}
+
+// true if every change of bDetected and every _setResult() is inside the body of an if with a compare condition
+static bool isDetectionGuarded(const QString &sCode)
+{
+    QMap<qint32, bool> mapIfCloses;  // Index of the ) of an if condition, is a compare condition
+    QSet<qint32> stDetections;
+
+    qint32 nSize = sCode.size();
+
+    QRegularExpressionMatchIterator iterIf = QRegularExpression("\\bif\\s*\\(").globalMatch(sCode);
+
+    while (iterIf.hasNext()) {
+        QRegularExpressionMatch matchIf = iterIf.next();
+        qint32 nOpen = matchIf.capturedEnd() - 1;
+        qint32 nDepth = 0;
+
+        for (qint32 i = nOpen; i < nSize; i++) {
+            if (sCode.at(i) == '(') {
+                nDepth++;
+            } else if (sCode.at(i) == ')') {
+                nDepth--;
+
+                if (nDepth == 0) {
+                    mapIfCloses.insert(i, isCompareCondition(sCode.mid(nOpen + 1, i - nOpen - 1)));
+                    break;
+                }
+            }
+        }
+    }
+
+    QRegularExpressionMatchIterator iterDetection =
+        QRegularExpression("\\bbDetected\\s*(?:[-+*/%|&^]?=|\\+\\+|--)|(?:\\+\\+|--)\\s*bDetected\\b|\\b_setResult\\s*\\(").globalMatch(sCode);
+
+    while (iterDetection.hasNext()) {
+        stDetections.insert(iterDetection.next().capturedStart());
+    }
+
+    QList<bool> listBlockGuards;        // One per open {
+    QList<qint32> listStatementGuards;  // Block depth of each open single statement body of a compare if
+    bool bIfBody = false;               // Between an if condition and its body
+    bool bIfGuard = false;
+    qint32 nParenDepth = 0;
+
+    for (qint32 i = 0; i < nSize; i++) {
+        QChar cChar = sCode.at(i);
+        bool bGuarded = (!listStatementGuards.isEmpty()) || ((!listBlockGuards.isEmpty()) && listBlockGuards.last());
+
+        if (bIfBody && (!cChar.isSpace())) {
+            bIfBody = false;
+
+            if (cChar == '{') {
+                listBlockGuards.append(bGuarded || bIfGuard);
+                continue;
+            } else if (bIfGuard) {
+                listStatementGuards.append(listBlockGuards.count());
+                bGuarded = true;
+            }
+        }
+
+        if (stDetections.contains(i) && (!bGuarded)) {
+            return false;
+        }
+
+        if (cChar == '{') {
+            listBlockGuards.append(bGuarded);
+        } else if (cChar == '}') {
+            if (listBlockGuards.isEmpty()) {
+                return false;
+            }
+
+            listBlockGuards.removeLast();
+
+            // Also ends a statement body that was this block, e.g. if (a) if (b) {...}
+            while ((!listStatementGuards.isEmpty()) && (listStatementGuards.last() >= listBlockGuards.count())) {
+                listStatementGuards.removeLast();
+            }
+        } else if (cChar == '(') {
+            nParenDepth++;
+        } else if (cChar == ')') {
+            nParenDepth--;
+
+            if (mapIfCloses.contains(i)) {
+                bIfBody = true;
+                bIfGuard = mapIfCloses.value(i);
+            }
+        } else if ((cChar == ';') && (nParenDepth == 0)) {
+            while ((!listStatementGuards.isEmpty()) && (listStatementGuards.last() >= listBlockGuards.count())) {
+                listStatementGuards.removeLast();
+            }
+        }
+    }
+
+    return listBlockGuards.isEmpty();
+}
+
+XScanLiteralIndex::XScanLiteralIndex()
+{
+    clear();
+}
+
+void XScanLiteralIndex::clear()
+{
+    m_listNodes.clear();
+    m_listPatterns.clear();
+    m_baAlwaysRun.clear();
+    m_nNumberOfSignatures = 0;
+    m_nNumberOfIndexedSignatures = 0;
+
+    for (qint32 i = 0; i < __WINDOW_SIZE; i++) {
+        m_nWindowEnd[i] = 0;
+    }
+
+    NODE root = {};
+    m_listNodes.append(root);
+}
+
+void XScanLiteralIndex::addSignature(qint32 nSignatureIndex, const QString &sText)
+{
+    if (nSignatureIndex >= m_nNumberOfSignatures) {
+        m_nNumberOfSignatures = nSignatureIndex + 1;
+        m_baAlwaysRun.resize(m_nNumberOfSignatures);
+    }
+
+    QList<LITERAL> listLiterals;
+
+    if (!extractLiterals(sText, &listLiterals)) {
+        m_baAlwaysRun.setBit(nSignatureIndex);
+        return;
+    }
+
+    qint32 nNumberOfLiterals = listLiterals.count();
+
+    for (qint32 i = 0; i < nNumberOfLiterals; i++) {
+        const LITERAL &literal = listLiterals.at(i);
+
+        qint32 nState = 0;
+        qint32 nSize = literal.baBytes.size();
+
+        for (qint32 j = 0; j < nSize; j++) {
+            quint8 nByte = (quint8)literal.baBytes.at(j);
+            qint32 nNext = m_listNodes.at(nState).mapNext.value(nByte, -1);
+
+            if (nNext == -1) {
+                NODE node = {};
+                m_listNodes.append(node);
+                nNext = m_listNodes.count() - 1;
+                m_listNodes[nState].mapNext.insert(nByte, nNext);
+            }
+
+            nState = nNext;
+        }
+
+        PATTERN pattern = {};
+        pattern.nSignatureIndex = nSignatureIndex;
+        pattern.window = literal.window;
+        pattern.nOffset = literal.nOffset;
+        pattern.nSize = nSize;
+
+        m_listPatterns.append(pattern);
+        m_listNodes[nState].listPatterns.append(m_listPatterns.count() - 1);
+
+        m_nWindowEnd[literal.window] = qMax(m_nWindowEnd[literal.window], literal.nOffset + nSize);
+    }
+
+    m_nNumberOfIndexedSignatures++;
+}
+
+void XScanLiteralIndex::setAlwaysRun(qint32 nSignatureIndex)
+{
+    if (nSignatureIndex < m_nNumberOfSignatures) {
+        m_baAlwaysRun.setBit(nSignatureIndex);
+    }
+}
+
+void XScanLiteralIndex::build()
+{
+    // Breadth-first failure links; outputs of the failure state are merged so matching never walks the chain
+    QQueue<qint32> queue;
+
+    QMap<quint8, qint32>::const_iterator iter = m_listNodes.at(0).mapNext.constBegin();
+
+    while (iter != m_listNodes.at(0).mapNext.constEnd()) {
+        m_listNodes[iter.value()].nFail = 0;
+        queue.enqueue(iter.value());
+        ++iter;
+    }
+
+    while (!queue.isEmpty()) {
+        qint32 nState = queue.dequeue();
+
+        QMap<quint8, qint32> mapNext = m_listNodes.at(nState).mapNext;
+        QMap<quint8, qint32>::const_iterator iterNext = mapNext.constBegin();
+
+        while (iterNext != mapNext.constEnd()) {
+            quint8 nByte = iterNext.key();
+            qint32 nChild = iterNext.value();
+
+            qint32 nFail = m_listNodes.at(nState).nFail;
+
+            while ((nFail != 0) && (!m_listNodes.at(nFail).mapNext.contains(nByte))) {
+                nFail = m_listNodes.at(nFail).nFail;
+            }
+
+            nFail = m_listNodes.at(nFail).mapNext.value(nByte, 0);
+
+            if (nFail == nChild) {
+                nFail = 0;
+            }
+
+            m_listNodes[nChild].nFail = nFail;
+            m_listNodes[nChild].listPatterns.append(m_listNodes.at(nFail).listPatterns);
+
+            queue.enqueue(nChild);
+
+            ++iterNext;
+        }
+    }
+}
+
+qint32 XScanLiteralIndex::getNumberOfSignatures() const
+{
+    return m_nNumberOfSignatures;
+}
+
+qint32 XScanLiteralIndex::getNumberOfIndexedSignatures() const
+{
+    return m_nNumberOfIndexedSignatures;
+}
+
+QBitArray XScanLiteralIndex::getCandidates(const QByteArray &baHeader, const QByteArray &baEntryPoint, const QByteArray &baOverlay) const
+{
+    QBitArray baResult = m_baAlwaysRun;
+
+    _match(baHeader, WINDOW_HEADER, &baResult);
+    _match(baEntryPoint, WINDOW_ENTRYPOINT, &baResult);
+    _match(baOverlay, WINDOW_OVERLAY, &baResult);
+
+    return baResult;
+}
+
+bool XScanLiteralIndex::extractLiterals(const QString &sText, QList<LITERAL> *pListLiterals)
+{
+    bool bResult = false;
+
+    // Skipping is only sound if every detection needs one of the compare calls to succeed: each change of bDetected and
+    // each _setResult() has to be under a plain if (X.compare(...) && ...). Negation, equality tests, alternatives and
+    // any other call, which may detect on its own, make the signature unfilterable. Strings and comments are not code
+    QString sCode = sText;
+    sCode.replace(QRegularExpression("\"(?:[^\"\\\\]|\\\\.)*\"|'(?:[^'\\\\]|\\\\.)*'"), "\"\"");
+    sCode.remove(QRegularExpression("//[^\\n]*|/\\*.*?\\*/", QRegularExpression::DotMatchesEverythingOption));
+
+    if (sCode.contains(QRegularExpression("\\belse\\b|\\bswitch\\b|\\|\\||\\?|!|=="))) {
+        return false;
+    }
+
+    QRegularExpression rxMethod("\\.\\s*([A-Za-z_]\\w*)\\s*\\(");
+    QRegularExpressionMatchIterator iterMethod = rxMethod.globalMatch(sCode);
+
+    while (iterMethod.hasNext()) {
+        QString sMethod = iterMethod.next().captured(1);
+
+        if ((sMethod != "compare") && (sMethod != "compareEP") && (sMethod != "compareOverlay") && (sMethod != "c")) {
+            return false;
+        }
+    }
+
+    // Global calls: only the script helpers that cannot detect, and _setResult() which is checked for its guard below
+    QString sGlobalCode = sCode;
+    sGlobalCode.replace(QRegularExpression("\\bfunction\\s+[A-Za-z_$][\\w$]*\\s*\\("), "function(");
+
+    QRegularExpression rxGlobal("(?<![\\w.$])([A-Za-z_$][\\w$]*)\\s*\\(");
+    QRegularExpressionMatchIterator iterGlobal = rxGlobal.globalMatch(sGlobalCode);
+
+    while (iterGlobal.hasNext()) {
+        QString sName = iterGlobal.next().captured(1);
+
+        if ((sName != "if") && (sName != "for") && (sName != "while") && (sName != "return") && (sName != "function") && (sName != "catch") &&
+            (sName != "typeof") && (sName != "init") && (sName != "meta") && (sName != "result") && (sName != "_setResult")) {
+            return false;
+        }
+    }
+
+    if (!isDetectionGuarded(sCode)) {
+        return false;
+    }
+
+    // X.c() is the short form of compare() used by the db helpers
+    QRegularExpression rxCall("(?:\\bcompareOverlay|\\bcompareEP|\\bcompare|\\.c)\\s*\\(([^)]*)\\)");
+    QRegularExpression rxArgs("^\\s*\"([^\"]*)\"\\s*(?:,\\s*(0x[0-9A-Fa-f]+|\\d+)\\s*)?$");
+
+    QRegularExpressionMatchIterator iterCall = rxCall.globalMatch(sText);
+
+    while (iterCall.hasNext()) {
+        QRegularExpressionMatch matchCall = iterCall.next();
+        QString sCall = matchCall.captured(0);
+        QRegularExpressionMatch matchArgs = rxArgs.match(matchCall.captured(1));
+
+        if (!matchArgs.hasMatch()) {
+            return false;
+        }
+
+        LITERAL literal = {};
+
+        if (sCall.startsWith("compareOverlay")) {
+            literal.window = WINDOW_OVERLAY;
+        } else if (sCall.startsWith("compareEP")) {
+            literal.window = WINDOW_ENTRYPOINT;
+        } else {
+            literal.window = WINDOW_HEADER;
+        }
+
+        bool bOffset = true;
+        QString sOffset = matchArgs.captured(2);
+
+        if (sOffset != "") {
+            literal.nOffset = sOffset.startsWith("0x") ? sOffset.mid(2).toInt(&bOffset, 16) : sOffset.toInt(&bOffset, 10);
+        }
+
+        literal.baBytes = signatureToLiteral(matchArgs.captured(1));
+
+        // A check that cannot be decided from the window makes the whole signature unfilterable
+        if ((!bOffset) || literal.baBytes.isEmpty() || ((literal.nOffset + literal.baBytes.size()) > WINDOW_SIZE)) {
+            return false;
+        }
+
+        pListLiterals->append(literal);
+        bResult = true;
+    }
+
+    return bResult;
+}
+
+QByteArray XScanLiteralIndex::signatureToLiteral(const QString &sSignature)
+{
+    QByteArray baResult;
+
+    QString _sSignature = sSignature;
+    _sSignature.remove(' ');
+
+    qint32 nSize = _sSignature.size();
+
+    // Only the fixed prefix: it ends at the first wildcard, jump or other non-literal token
+    for (qint32 i = 0; i < nSize;) {
+        QChar cChar = _sSignature.at(i);
+
+        if (cChar == '\'') {
+            qint32 nEnd = _sSignature.indexOf('\'', i + 1);
+
+            if (nEnd == -1) {
+                break;
+            }
+
+            baResult.append(_sSignature.mid(i + 1, nEnd - i - 1).toLatin1());
+            i = nEnd + 1;
+        } else if ((i + 1 < nSize) && isHexDigit(cChar) && isHexDigit(_sSignature.at(i + 1))) {
+            baResult.append((char)_sSignature.mid(i, 2).toUInt(nullptr, 16));
+            i += 2;
+        } else {
+            break;
+        }
+    }
+
+    return baResult;
+}
+
+qint32 XScanLiteralIndex::_getNext(qint32 nState, quint8 nByte) const
+{
+    qint32 nResult = m_listNodes.at(nState).mapNext.value(nByte, -1);
+
+    while ((nResult == -1) && (nState != 0)) {
+        nState = m_listNodes.at(nState).nFail;
+        nResult = m_listNodes.at(nState).mapNext.value(nByte, -1);
+    }
+
+    if (nResult == -1) {
+        nResult = 0;
+    }
+
+    return nResult;
+}
+
+void XScanLiteralIndex::_match(const QByteArray &baData, WINDOW window, QBitArray *pBitArray) const
+{
+    qint32 nSize = qMin(baData.size(), m_nWindowEnd[window]);
+    const char *pData = baData.constData();
+
+    qint32 nState = 0;
+
+    for (qint32 i = 0; i < nSize; i++) {
+        nState = _getNext(nState, (quint8)pData[i]);
+
+        const QList<qint32> &listPatterns = m_listNodes.at(nState).listPatterns;
+        qint32 nNumberOfPatterns = listPatterns.count();
+
+        for (qint32 j = 0; j < nNumberOfPatterns; j++) {
+            const PATTERN &pattern = m_listPatterns.at(listPatterns.at(j));
+
+            if ((pattern.window == window) && ((i - pattern.nSize + 1) == pattern.nOffset)) {
+                pBitArray->setBit(pattern.nSignatureIndex);
+            }
+        }
+    }
+}
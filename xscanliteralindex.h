@@ -0,0 +1,90 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef XSCANLITERALINDEX_H
+#define XSCANLITERALINDEX_H
+
+#include <QBitArray>
+#include <QByteArray>
+#include <QList>
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+// Aho-Corasick automaton over the literal bytes of compare()/compareEP()/compareOverlay() checks.
+// A signature is a candidate if one of its literals occurs at its anchor in the header, entry point or overlay window.
+// Signatures with any check that has no extractable literal, or with a bDetected/_setResult() that is not under a plain
+// if (X.compare(...) && ...), are always candidates.
+class XScanLiteralIndex {
+public:
+    enum WINDOW {
+        WINDOW_HEADER = 0,
+        WINDOW_ENTRYPOINT,
+        WINDOW_OVERLAY,
+        __WINDOW_SIZE
+    };
+
+    struct LITERAL {
+        WINDOW window;
+        qint32 nOffset;  // Anchor inside the window
+        QByteArray baBytes;
+    };
+
+    XScanLiteralIndex();
+
+    void clear();
+    void addSignature(qint32 nSignatureIndex, const QString &sText);
+    void setAlwaysRun(qint32 nSignatureIndex);  // For a signature edited after build(); its old literals are then harmless
+    void build();
+    qint32 getNumberOfSignatures() const;
+    qint32 getNumberOfIndexedSignatures() const;
+    QBitArray getCandidates(const QByteArray &baHeader, const QByteArray &baEntryPoint, const QByteArray &baOverlay) const;
+
+    static bool extractLiterals(const QString &sText, QList<LITERAL> *pListLiterals);
+    static QByteArray signatureToLiteral(const QString &sSignature);
+
+    static const qint32 WINDOW_SIZE = 256;  // Same as the signatures cached by Binary_Script
+
+private:
+    struct NODE {
+        QMap<quint8, qint32> mapNext;
+        qint32 nFail;
+        QList<qint32> listPatterns;
+    };
+
+    struct PATTERN {
+        qint32 nSignatureIndex;
+        WINDOW window;
+        qint32 nOffset;
+        qint32 nSize;
+    };
+
+    qint32 _getNext(qint32 nState, quint8 nByte) const;
+    void _match(const QByteArray &baData, WINDOW window, QBitArray *pBitArray) const;
+
+    QVector<NODE> m_listNodes;
+    QList<PATTERN> m_listPatterns;
+    QBitArray m_baAlwaysRun;
+    qint32 m_nNumberOfSignatures;
+    qint32 m_nNumberOfIndexedSignatures;
+    qint32 m_nWindowEnd[__WINDOW_SIZE];
+};
+
+#endif  // XSCANLITERALINDEX_H
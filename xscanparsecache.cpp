@@ -0,0 +1,123 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xscanparsecache.h"
+
+XScanParseCache::XScanParseCache()
+{
+    m_nHits = 0;
+    m_nMisses = 0;
+}
+
+void XScanParseCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_mapRecords.clear();
+    m_nHits = 0;
+    m_nMisses = 0;
+}
+
+XScanParseCache::RECORD XScanParseCache::getRecord(XBinary *pBinary, XBinary::PDSTRUCT *pPdStruct)
+{
+    return _getRecord(pBinary, true, pPdStruct);
+}
+
+XBinary::FILEFORMATINFO XScanParseCache::getFileFormatInfo(XBinary *pBinary, XBinary::PDSTRUCT *pPdStruct)
+{
+    return _getRecord(pBinary, false, pPdStruct).fileFormatInfo;
+}
+
+qint64 XScanParseCache::getNumberOfHits()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_nHits;
+}
+
+qint64 XScanParseCache::getNumberOfMisses()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_nMisses;
+}
+
+void XScanParseCache::loadMemoryMap(XBinary *pBinary, RECORD *pRecord, XBinary::PDSTRUCT *pPdStruct)
+{
+    pRecord->memoryMap = pBinary->getMemoryMap(XBinary::MAPMODE_UNKNOWN, pPdStruct);
+    pRecord->nEntryPointOffset = pBinary->getEntryPointOffset(&(pRecord->memoryMap));
+    pRecord->nEntryPointAddress = pBinary->getEntryPointAddress(&(pRecord->memoryMap));
+    pRecord->nOverlayOffset = pBinary->getOverlayOffset(&(pRecord->memoryMap), pPdStruct);
+    pRecord->nOverlaySize = pBinary->getOverlaySize(&(pRecord->memoryMap), pPdStruct);
+    pRecord->bIsOverlayPresent = pBinary->isOverlayPresent(&(pRecord->memoryMap), pPdStruct);
+    pRecord->bIsMemoryMapLoaded = true;
+}
+
+void XScanParseCache::loadFileFormatInfo(XBinary *pBinary, RECORD *pRecord, XBinary::PDSTRUCT *pPdStruct)
+{
+    pRecord->fileFormatInfo = pBinary->getFileFormatInfo(pPdStruct);
+    pRecord->bIsFileFormatInfoLoaded = true;
+}
+
+XScanParseCache::RECORD XScanParseCache::_getRecord(XBinary *pBinary, bool bMemoryMap, XBinary::PDSTRUCT *pPdStruct)
+{
+    QString sKey = _getKey(pBinary);
+
+    QMutexLocker locker(&m_mutex);
+
+    RECORD record = {};
+
+    QHash<QString, RECORD>::const_iterator iter = m_mapRecords.constFind(sKey);
+
+    if (iter != m_mapRecords.constEnd()) {
+        record = iter.value();
+    }
+
+    if (record.bIsFileFormatInfoLoaded && (record.bIsMemoryMapLoaded || (!bMemoryMap))) {
+        m_nHits++;
+    } else {
+        m_nMisses++;
+
+        if (bMemoryMap && (!record.bIsMemoryMapLoaded)) {
+            loadMemoryMap(pBinary, &record, pPdStruct);
+        }
+
+        if (!record.bIsFileFormatInfoLoaded) {
+            loadFileFormatInfo(pBinary, &record, pPdStruct);
+        }
+
+        // Results of a cancelled parse may be incomplete and are not shared
+        if (XBinary::isPdStructNotCanceled(pPdStruct)) {
+            m_mapRecords.insert(sKey, record);
+        }
+    }
+
+    return record;
+}
+
+QString XScanParseCache::_getKey(XBinary *pBinary)
+{
+    // The memory map and the entry point depend on the image mode and the module address as well as on the device
+    return QString("%1:%2:%3:%4")
+        .arg(pBinary->metaObject()->className())
+        .arg((quint64)(pBinary->getDevice()))
+        .arg(pBinary->isImage())
+        .arg((quint64)(pBinary->getModuleAddress()));
+}
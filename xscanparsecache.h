@@ -0,0 +1,67 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef XSCANPARSECACHE_H
+#define XSCANPARSECACHE_H
+
+#include <QHash>
+#include <QMutex>
+
+#include "xformats.h"
+
+// Parse results of one scanned device, shared by the detection passes of one scan.
+// Keyed by format class, device, image mode and module address: the memory map and format info of XPE and XMSDOS over the same bytes differ,
+// and so do those of one format loaded as a file and as a mapped image.
+class XScanParseCache {
+public:
+    struct RECORD {
+        bool bIsMemoryMapLoaded;  // memoryMap, entry point and overlay
+        XBinary::_MEMORY_MAP memoryMap;
+        qint64 nEntryPointOffset;
+        qint64 nEntryPointAddress;
+        qint64 nOverlayOffset;
+        qint64 nOverlaySize;
+        bool bIsOverlayPresent;
+        bool bIsFileFormatInfoLoaded;
+        XBinary::FILEFORMATINFO fileFormatInfo;
+    };
+
+    XScanParseCache();
+
+    void clear();
+    RECORD getRecord(XBinary *pBinary, XBinary::PDSTRUCT *pPdStruct);
+    XBinary::FILEFORMATINFO getFileFormatInfo(XBinary *pBinary, XBinary::PDSTRUCT *pPdStruct);
+    qint64 getNumberOfHits();
+    qint64 getNumberOfMisses();
+
+    static void loadMemoryMap(XBinary *pBinary, RECORD *pRecord, XBinary::PDSTRUCT *pPdStruct);
+    static void loadFileFormatInfo(XBinary *pBinary, RECORD *pRecord, XBinary::PDSTRUCT *pPdStruct);
+
+private:
+    RECORD _getRecord(XBinary *pBinary, bool bMemoryMap, XBinary::PDSTRUCT *pPdStruct);
+    static QString _getKey(XBinary *pBinary);
+
+    QMutex m_mutex;
+    QHash<QString, RECORD> m_mapRecords;
+    qint64 m_nHits;
+    qint64 m_nMisses;
+};
+
+#endif  // XSCANPARSECACHE_H
@@ -0,0 +1,263 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xscanprofiler.h"
+
+#include <algorithm>
+
+static bool sort_profiler_total(const XScanProfiler::RECORD &record1, const XScanProfiler::RECORD &record2)
+{
+    if (record1.nTotalNs != record2.nTotalNs) {
+        return record1.nTotalNs > record2.nTotalNs;
+    }
+
+    return record1.sName < record2.sName;
+}
+
+static QString csvQuote(const QString &sString)
+{
+    QString sResult = sString;
+
+    if (sResult.contains(',') || sResult.contains('"') || sResult.contains('\n')) {
+        sResult.replace("\"", "\"\"");
+        sResult = QString("\"%1\"").arg(sResult);
+    }
+
+    return sResult;
+}
+
+XScanProfiler::XScanProfiler()
+{
+}
+
+void XScanProfiler::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_mapRecords.clear();
+}
+
+void XScanProfiler::addSample(CATEGORY category, const QString &sName, qint64 nElapsedNs)
+{
+    QString sKey = QString("%1:%2").arg(QString::number(category), sName);
+
+    QMutexLocker locker(&m_mutex);
+
+    QMap<QString, RECORD>::iterator iter = m_mapRecords.find(sKey);
+
+    if (iter == m_mapRecords.end()) {
+        RECORD record = {};
+        record.category = category;
+        record.sName = sName;
+        record.nMinNs = nElapsedNs;
+
+        iter = m_mapRecords.insert(sKey, record);
+    }
+
+    RECORD &record = iter.value();
+
+    record.nCount++;
+    record.nTotalNs += nElapsedNs;
+    record.nMinNs = qMin(record.nMinNs, nElapsedNs);
+    record.nMaxNs = qMax(record.nMaxNs, nElapsedNs);
+    record.nHistogram[getHistogramBucket(nElapsedNs)]++;
+}
+
+void XScanProfiler::addCount(const QString &sName)
+{
+    QString sKey = QString("%1:%2").arg(QString::number(CATEGORY_COUNTER), sName);
+
+    QMutexLocker locker(&m_mutex);
+
+    QMap<QString, RECORD>::iterator iter = m_mapRecords.find(sKey);
+
+    if (iter == m_mapRecords.end()) {
+        RECORD record = {};
+        record.category = CATEGORY_COUNTER;
+        record.sName = sName;
+
+        iter = m_mapRecords.insert(sKey, record);
+    }
+
+    iter.value().nCount++;
+}
+
+QList<XScanProfiler::RECORD> XScanProfiler::getRecords()
+{
+    QList<RECORD> listResult;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        listResult = m_mapRecords.values();
+    }
+
+    std::sort(listResult.begin(), listResult.end(), sort_profiler_total);
+
+    return listResult;
+}
+
+QString XScanProfiler::toJson()
+{
+    QJsonArray jsArray;
+
+    QList<RECORD> listRecords = getRecords();
+    qint32 nNumberOfRecords = listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const RECORD &record = listRecords.at(i);
+
+        QJsonObject jsRecord;
+        jsRecord.insert("category", categoryToString(record.category));
+        jsRecord.insert("name", record.sName);
+        jsRecord.insert("count", record.nCount);
+        jsRecord.insert("total_ns", record.nTotalNs);
+        jsRecord.insert("min_ns", record.nMinNs);
+        jsRecord.insert("max_ns", record.nMaxNs);
+
+        QJsonObject jsHistogram;
+
+        for (qint32 j = 0; j < HISTOGRAM_SIZE; j++) {
+            jsHistogram.insert(histogramBucketToString(j), record.nHistogram[j]);
+        }
+
+        jsRecord.insert("histogram", jsHistogram);
+
+        jsArray.append(jsRecord);
+    }
+
+    QJsonObject jsResult;
+    jsResult.insert("profiling", jsArray);
+
+    return QJsonDocument(jsResult).toJson(QJsonDocument::Indented);
+}
+
+QString XScanProfiler::toCsv()
+{
+    QString sResult = "category,name,count,total_ns,min_ns,max_ns";
+
+    for (qint32 i = 0; i < HISTOGRAM_SIZE; i++) {
+        sResult += QString(",%1").arg(histogramBucketToString(i));
+    }
+
+    sResult += "\n";
+
+    QList<RECORD> listRecords = getRecords();
+    qint32 nNumberOfRecords = listRecords.count();
+
+    for (qint32 i = 0; i < nNumberOfRecords; i++) {
+        const RECORD &record = listRecords.at(i);
+
+        sResult += QString("%1,%2,%3,%4,%5,%6")
+                       .arg(categoryToString(record.category), csvQuote(record.sName))
+                       .arg(record.nCount)
+                       .arg(record.nTotalNs)
+                       .arg(record.nMinNs)
+                       .arg(record.nMaxNs);
+
+        for (qint32 j = 0; j < HISTOGRAM_SIZE; j++) {
+            sResult += QString(",%1").arg(record.nHistogram[j]);
+        }
+
+        sResult += "\n";
+    }
+
+    return sResult;
+}
+
+bool XScanProfiler::save(const QString &sFileName)
+{
+    bool bResult = false;
+
+    QString sData;
+
+    if (sFileName.endsWith(".csv", Qt::CaseInsensitive)) {
+        sData = toCsv();
+    } else {
+        sData = toJson();
+    }
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if (file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+        bResult = (file.write(sData.toUtf8()) != -1);
+        file.close();
+    }
+
+    return bResult;
+}
+
+QString XScanProfiler::categoryToString(CATEGORY category)
+{
+    QString sResult;
+
+    if (category == CATEGORY_SIGNATURE) {
+        sResult = "signature";
+    } else if (category == CATEGORY_API) {
+        sResult = "api";
+    } else if (category == CATEGORY_TIMING) {
+        sResult = "timing";
+    } else if (category == CATEGORY_DETECT) {
+        sResult = "detect";
+    } else if (category == CATEGORY_COUNTER) {
+        sResult = "counter";
+    }
+
+    return sResult;
+}
+
+QString XScanProfiler::histogramBucketToString(qint32 nIndex)
+{
+    QString sResult;
+
+    if (nIndex == 0) {
+        sResult = "lt_1us";
+    } else if (nIndex == 1) {
+        sResult = "lt_10us";
+    } else if (nIndex == 2) {
+        sResult = "lt_100us";
+    } else if (nIndex == 3) {
+        sResult = "lt_1ms";
+    } else if (nIndex == 4) {
+        sResult = "lt_10ms";
+    } else if (nIndex == 5) {
+        sResult = "lt_100ms";
+    } else if (nIndex == 6) {
+        sResult = "lt_1s";
+    } else {
+        sResult = "ge_1s";
+    }
+
+    return sResult;
+}
+
+qint32 XScanProfiler::getHistogramBucket(qint64 nElapsedNs)
+{
+    qint32 nResult = 0;
+    qint64 nLimit = 1000;
+
+    while ((nResult < (HISTOGRAM_SIZE - 1)) && (nElapsedNs >= nLimit)) {
+        nResult++;
+        nLimit *= 10;
+    }
+
+    return nResult;
+}
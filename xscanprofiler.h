@@ -0,0 +1,77 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef XSCANPROFILER_H
+#define XSCANPROFILER_H
+
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QList>
+#include <QMap>
+#include <QMutex>
+#include <QString>
+
+// Aggregated timings of signatures, script API calls and detection passes.
+// Samples from parallel scans can be added concurrently.
+class XScanProfiler {
+public:
+    enum CATEGORY {
+        CATEGORY_SIGNATURE = 0,
+        CATEGORY_API,
+        CATEGORY_TIMING,  // startTiming()/endTiming() blocks in scripts
+        CATEGORY_DETECT,
+        CATEGORY_COUNTER  // addCount(): events without a duration, the times stay 0
+    };
+
+    // Upper bounds: 1 us, 10 us, 100 us, 1 ms, 10 ms, 100 ms, 1 s, then everything slower
+    static const qint32 HISTOGRAM_SIZE = 8;
+
+    struct RECORD {
+        CATEGORY category;
+        QString sName;
+        qint64 nCount;
+        qint64 nTotalNs;
+        qint64 nMinNs;
+        qint64 nMaxNs;
+        qint64 nHistogram[HISTOGRAM_SIZE];
+    };
+
+    XScanProfiler();
+
+    void clear();
+    void addSample(CATEGORY category, const QString &sName, qint64 nElapsedNs);
+    void addCount(const QString &sName);
+    QList<RECORD> getRecords();  // Sorted by total time, slowest first
+    QString toJson();
+    QString toCsv();
+    bool save(const QString &sFileName);  // CSV for *.csv, otherwise JSON
+
+    static QString categoryToString(CATEGORY category);
+    static QString histogramBucketToString(qint32 nIndex);
+    static qint32 getHistogramBucket(qint64 nElapsedNs);
+
+private:
+    QMutex m_mutex;
+    QMap<QString, RECORD> m_mapRecords;  // Key: category + name
+};
+
+#endif  // XSCANPROFILER_H
@@ -0,0 +1,286 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xscanresultcache.h"
+
+#include <QSaveFile>
+
+static void writeScanId(QDataStream &stream, const XScanEngine::SCANID &scanId)
+{
+    stream << scanId.sUuid << (quint32)scanId.fileType << (quint32)scanId.filePart << scanId.sVersion << scanId.sInfo << scanId.nSize << scanId.nOffset
+           << scanId.sOriginalName;
+}
+
+static void readScanId(QDataStream &stream, XScanEngine::SCANID *pScanId)
+{
+    quint32 nFileType = 0;
+    quint32 nFilePart = 0;
+
+    stream >> pScanId->sUuid >> nFileType >> nFilePart >> pScanId->sVersion >> pScanId->sInfo >> pScanId->nSize >> pScanId->nOffset >> pScanId->sOriginalName;
+
+    pScanId->fileType = (XBinary::FT)nFileType;
+    pScanId->filePart = (XBinary::FILEPART)nFilePart;
+}
+
+XScanResultCache::XScanResultCache(qint32 nMaxRecords)
+{
+    m_nMaxRecords = nMaxRecords;
+    m_nHits = 0;
+    m_nMisses = 0;
+}
+
+void XScanResultCache::setDirectory(const QString &sDirectory)
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_sDirectory = sDirectory;
+
+    if ((m_sDirectory != "") && (!XBinary::isDirectoryExists(m_sDirectory))) {
+        XBinary::createDirectory(m_sDirectory);
+    }
+}
+
+QString XScanResultCache::getDirectory()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_sDirectory;
+}
+
+void XScanResultCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+
+    m_mapRecords.clear();
+    m_queueKeys.clear();
+    m_nHits = 0;
+    m_nMisses = 0;
+}
+
+bool XScanResultCache::find(const QString &sKey, RECORD *pRecord)
+{
+    bool bResult = false;
+    QString sDirectory;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        QHash<QString, RECORD>::const_iterator iter = m_mapRecords.constFind(sKey);
+
+        if (iter != m_mapRecords.constEnd()) {
+            *pRecord = iter.value();
+            bResult = true;
+        } else {
+            sDirectory = m_sDirectory;
+        }
+    }
+
+    // Disk I/O without the lock, other workers keep using the memory records
+    bool bLoaded = false;
+
+    if ((!bResult) && (sDirectory != "")) {
+        bLoaded = _load(_getFileName(sDirectory, sKey), pRecord);
+    }
+
+    QMutexLocker locker(&m_mutex);
+
+    if (bLoaded) {
+        _insert(sKey, *pRecord);
+        bResult = true;
+    }
+
+    if (bResult) {
+        m_nHits++;
+    } else {
+        m_nMisses++;
+    }
+
+    return bResult;
+}
+
+void XScanResultCache::insert(const QString &sKey, const RECORD &record)
+{
+    QString sDirectory;
+
+    {
+        QMutexLocker locker(&m_mutex);
+
+        _insert(sKey, record);
+
+        sDirectory = m_sDirectory;
+    }
+
+    if (sDirectory != "") {
+        _save(_getFileName(sDirectory, sKey), record);
+    }
+}
+
+qint64 XScanResultCache::getNumberOfHits()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_nHits;
+}
+
+qint64 XScanResultCache::getNumberOfMisses()
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_nMisses;
+}
+
+QString XScanResultCache::_getFileName(const QString &sDirectory, const QString &sKey)
+{
+    // Two-character fan-out keeps directories small on large corpora
+    return sDirectory + QDir::separator() + sKey.left(2) + QDir::separator() + sKey + ".result";
+}
+
+bool XScanResultCache::_load(const QString &sFileName, RECORD *pRecord)
+{
+    bool bResult = false;
+
+    QFile file;
+    file.setFileName(sFileName);
+
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream stream(&file);
+
+        quint32 nMagic = 0;
+        quint32 nVersion = 0;
+        quint32 nFileType = 0;
+
+        stream >> nMagic >> nVersion;
+
+        if ((nMagic == FILE_MAGIC) && (nVersion == FILE_VERSION)) {
+            *pRecord = {};
+
+            stream >> nFileType;
+            pRecord->ftInit = (XBinary::FT)nFileType;
+
+            qint32 nNumberOfRecords = 0;
+            stream >> nNumberOfRecords;
+
+            for (qint32 i = 0; (i < nNumberOfRecords) && (stream.status() == QDataStream::Ok); i++) {
+                XScanEngine::SCANSTRUCT scanStruct = {};
+                quint32 nType = 0;
+                quint32 nName = 0;
+
+                stream >> scanStruct.bIsHeuristic >> scanStruct.bIsAHeuristic >> scanStruct.bIsUnknown;
+                readScanId(stream, &scanStruct.id);
+                readScanId(stream, &scanStruct.parentId);
+                stream >> nType >> nName >> scanStruct.sType >> scanStruct.sName >> scanStruct.sVersion >> scanStruct.sInfo >> scanStruct.varInfo >>
+                    scanStruct.varInfo2 >> scanStruct.nPrio;
+
+                scanStruct.type = (XScanEngine::RECORD_TYPE)nType;
+                scanStruct.name = (XScanEngine::RECORD_NAME)nName;
+
+                pRecord->listRecords.append(scanStruct);
+            }
+
+            qint32 nNumberOfErrors = 0;
+            stream >> nNumberOfErrors;
+
+            for (qint32 i = 0; (i < nNumberOfErrors) && (stream.status() == QDataStream::Ok); i++) {
+                XScanEngine::ERROR_RECORD errorRecord = {};
+                stream >> errorRecord.sScript >> errorRecord.sErrorString;
+
+                pRecord->listErrors.append(errorRecord);
+            }
+
+            qint32 nNumberOfDebugRecords = 0;
+            stream >> nNumberOfDebugRecords;
+
+            for (qint32 i = 0; (i < nNumberOfDebugRecords) && (stream.status() == QDataStream::Ok); i++) {
+                XScanEngine::DEBUG_RECORD debugRecord = {};
+                stream >> debugRecord.sScript >> debugRecord.sType >> debugRecord.sName >> debugRecord.sValue >> debugRecord.nElapsedTime >> debugRecord.nLine;
+
+                pRecord->listDebugRecords.append(debugRecord);
+            }
+
+            bResult = (stream.status() == QDataStream::Ok);
+        }
+
+        file.close();
+    }
+
+    return bResult;
+}
+
+void XScanResultCache::_save(const QString &sFileName, const RECORD &record)
+{
+    QString sDirectory = QFileInfo(sFileName).absolutePath();
+
+    if (!XBinary::isDirectoryExists(sDirectory)) {
+        XBinary::createDirectory(sDirectory);
+    }
+
+    // Renamed into place on commit(), a concurrent reader never sees a partial file
+    QSaveFile file(sFileName);
+
+    if (file.open(QIODevice::WriteOnly)) {
+        QDataStream stream(&file);
+
+        stream << FILE_MAGIC << FILE_VERSION << (quint32)record.ftInit;
+
+        qint32 nNumberOfRecords = record.listRecords.count();
+        stream << nNumberOfRecords;
+
+        for (qint32 i = 0; i < nNumberOfRecords; i++) {
+            const XScanEngine::SCANSTRUCT &scanStruct = record.listRecords.at(i);
+
+            stream << scanStruct.bIsHeuristic << scanStruct.bIsAHeuristic << scanStruct.bIsUnknown;
+            writeScanId(stream, scanStruct.id);
+            writeScanId(stream, scanStruct.parentId);
+            stream << (quint32)scanStruct.type << (quint32)scanStruct.name << scanStruct.sType << scanStruct.sName << scanStruct.sVersion << scanStruct.sInfo
+                   << scanStruct.varInfo << scanStruct.varInfo2 << scanStruct.nPrio;
+        }
+
+        qint32 nNumberOfErrors = record.listErrors.count();
+        stream << nNumberOfErrors;
+
+        for (qint32 i = 0; i < nNumberOfErrors; i++) {
+            stream << record.listErrors.at(i).sScript << record.listErrors.at(i).sErrorString;
+        }
+
+        qint32 nNumberOfDebugRecords = record.listDebugRecords.count();
+        stream << nNumberOfDebugRecords;
+
+        for (qint32 i = 0; i < nNumberOfDebugRecords; i++) {
+            const XScanEngine::DEBUG_RECORD &debugRecord = record.listDebugRecords.at(i);
+
+            stream << debugRecord.sScript << debugRecord.sType << debugRecord.sName << debugRecord.sValue << debugRecord.nElapsedTime << debugRecord.nLine;
+        }
+
+        file.commit();
+    }
+}
+
+void XScanResultCache::_insert(const QString &sKey, const RECORD &record)
+{
+    if (!m_mapRecords.contains(sKey)) {
+        while ((m_nMaxRecords > 0) && (m_queueKeys.count() >= m_nMaxRecords)) {
+            m_mapRecords.remove(m_queueKeys.dequeue());
+        }
+
+        m_queueKeys.enqueue(sKey);
+    }
+
+    m_mapRecords.insert(sKey, record);
+}
@@ -0,0 +1,69 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef XSCANRESULTCACHE_H
+#define XSCANRESULTCACHE_H
+
+#include <QMutex>
+#include <QQueue>
+
+#include "xscanengine.h"
+
+// Scan results keyed by content hash, database fingerprint and the options that change detection.
+// Kept in memory and, if a directory is set, in one file per key so later runs can reuse them.
+class XScanResultCache {
+public:
+    struct RECORD {
+        XBinary::FT ftInit;
+        QList<XScanEngine::SCANSTRUCT> listRecords;  // Offsets are relative to the scanned device, see XScanEngine::scanProcess
+        QList<XScanEngine::ERROR_RECORD> listErrors;
+        QList<XScanEngine::DEBUG_RECORD> listDebugRecords;
+    };
+
+    explicit XScanResultCache(qint32 nMaxRecords = 100000);  // Records kept in memory, 0: no limit
+
+    void setDirectory(const QString &sDirectory);  // Empty: memory only
+    QString getDirectory();
+    void clear();  // Memory only, the directory is kept
+    bool find(const QString &sKey, RECORD *pRecord);
+    void insert(const QString &sKey, const RECORD &record);
+    qint64 getNumberOfHits();
+    qint64 getNumberOfMisses();
+
+private:
+    // Disk I/O, called without m_mutex
+    static QString _getFileName(const QString &sDirectory, const QString &sKey);
+    static bool _load(const QString &sFileName, RECORD *pRecord);
+    static void _save(const QString &sFileName, const RECORD &record);
+    void _insert(const QString &sKey, const RECORD &record);
+
+    static const quint32 FILE_MAGIC = 0x58535243;  // "XSRC"
+    static const quint32 FILE_VERSION = 1;
+
+    QMutex m_mutex;
+    qint32 m_nMaxRecords;
+    QString m_sDirectory;
+    QHash<QString, RECORD> m_mapRecords;
+    QQueue<QString> m_queueKeys;  // Insertion order, the oldest record is dropped first
+    qint64 m_nHits;
+    qint64 m_nMisses;
+};
+
+#endif  // XSCANRESULTCACHE_H
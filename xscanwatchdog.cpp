@@ -0,0 +1,94 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#include "xscanwatchdog.h"
+
+XScanWatchdog::XScanWatchdog(QObject *pParent) : QThread(pParent)
+{
+    m_nNextHandle = 0;
+    m_bIsStop = false;
+}
+
+XScanWatchdog::~XScanWatchdog()
+{
+    {
+        QMutexLocker locker(&m_mutex);
+
+        m_bIsStop = true;
+        m_waitCondition.wakeAll();
+    }
+
+    wait();
+}
+
+qint32 XScanWatchdog::add(XBinary::PDSTRUCT *pPdStruct, XBinary::PDSTRUCT *pPdStructParent, qint64 nTimeout)
+{
+    QMutexLocker locker(&m_mutex);
+
+    WATCH watch = {};
+    watch.pPdStruct = pPdStruct;
+    watch.pPdStructParent = pPdStructParent;
+    watch.nTimeout = nTimeout;
+    watch.timer.start();
+
+    qint32 nResult = m_nNextHandle++;
+
+    m_mapWatches.insert(nResult, watch);
+
+    // Started on first use, most scans have no budget
+    if (!isRunning()) {
+        start();
+    }
+
+    return nResult;
+}
+
+bool XScanWatchdog::remove(qint32 nHandle)
+{
+    QMutexLocker locker(&m_mutex);
+
+    return m_mapWatches.take(nHandle).bIsTimeout;
+}
+
+void XScanWatchdog::run()
+{
+    QMutexLocker locker(&m_mutex);
+
+    while (!m_bIsStop) {
+        QMap<qint32, WATCH>::iterator iter = m_mapWatches.begin();
+
+        while (iter != m_mapWatches.end()) {
+            WATCH &watch = iter.value();
+
+            if (watch.pPdStructParent && watch.pPdStructParent->bIsStop) {
+                watch.pPdStruct->bIsStop = true;
+            }
+
+            if ((watch.nTimeout > 0) && (!watch.bIsTimeout) && (watch.timer.elapsed() >= watch.nTimeout)) {
+                watch.bIsTimeout = true;
+                watch.pPdStruct->bIsStop = true;
+            }
+
+            ++iter;
+        }
+
+        m_waitCondition.wait(&m_mutex, INTERVAL);
+    }
+}
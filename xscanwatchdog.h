@@ -0,0 +1,65 @@
+/* Copyright (c) 2026 hors<horsicq@gmail.com>
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+ */
+#ifndef XSCANWATCHDOG_H
+#define XSCANWATCHDOG_H
+
+#include <QElapsedTimer>
+#include <QMap>
+#include <QMutex>
+#include <QThread>
+#include <QWaitCondition>
+
+#include "xbinary.h"
+
+// Stops a PDSTRUCT when its wall-clock budget runs out or its parent is stopped.
+// Scans only poll bIsStop, so a long XBinary loop is interrupted without any change to it.
+class XScanWatchdog : public QThread {
+    Q_OBJECT
+
+public:
+    explicit XScanWatchdog(QObject *pParent = nullptr);
+    ~XScanWatchdog();
+
+    qint32 add(XBinary::PDSTRUCT *pPdStruct, XBinary::PDSTRUCT *pPdStructParent, qint64 nTimeout);  // nTimeout in ms, 0: no limit; returns a handle
+    bool remove(qint32 nHandle);                                                                      // true if the budget ran out
+
+protected:
+    void run() override;
+
+private:
+    struct WATCH {
+        XBinary::PDSTRUCT *pPdStruct;
+        XBinary::PDSTRUCT *pPdStructParent;  // Optional
+        QElapsedTimer timer;
+        qint64 nTimeout;
+        bool bIsTimeout;
+    };
+
+    static const qint32 INTERVAL = 10;  // ms between checks
+
+    QMutex m_mutex;
+    QWaitCondition m_waitCondition;
+    QMap<qint32, WATCH> m_mapWatches;
+    qint32 m_nNextHandle;
+    bool m_bIsStop;
+};
+
+#endif  // XSCANWATCHDOG_H